@@ -1,5 +1,6 @@
 #include "argparse/argparse.hpp"
 #include "commons.hpp"
+#include "heat_reference.hpp"
 
 #include <cuda_runtime.h>
 #include <thrust/execution_policy.h>
@@ -16,6 +17,9 @@ struct args_params_t : public argparse::Args {
   bool& k = kwarg("k", "Heat transfer coefficient").set_default(0.5);
   double& dt = kwarg("dt", "Timestep unit (default: 1.0[s])").set_default(1.0);
   double& dx = kwarg("dx", "Local x dimension").set_default(1.0);
+  bool& validate =
+      kwarg("validate", "print the max error against the spectral solution")
+          .set_default(false);
   bool& no_header =
       kwarg("no-header", "Do not print csv header row (default: false)")
           .set_default(false);
@@ -59,7 +63,8 @@ int benchmark(args_params_t const& args) {
   Timer timer;
 
   // Memory allocation
-  if (args.results) {
+  bool host = args.results || args.validate;
+  if (host) {
     h_current = new double[size];
     h_next = new double[size];
   }
@@ -83,11 +88,13 @@ int benchmark(args_params_t const& args) {
   cudaDeviceSynchronize();
   auto time = timer.stop();
 
-  if (args.results) {
+  if (host) {
     // Copy result back to host
     cudaMemcpy(h_current, d_current, size * sizeof(double),
                cudaMemcpyDeviceToHost);
+  }
 
+  if (args.results) {
     // Print results
     for (std::size_t i = 0; i < np; ++i) {
       std::cout << "U[" << i << "] = {";
@@ -96,11 +103,18 @@ int benchmark(args_params_t const& args) {
       }
       std::cout << "}\n";
     }
-    // Cleanup
-    delete[] h_current;
-    delete[] h_next;
   }
 
+  if (args.validate) {
+    validate_heat(
+        std::execution::seq, [&](std::size_t i) { return h_current[i]; },
+        size, nt, k * dt / (dx * dx));
+  }
+
+  // Cleanup
+  delete[] h_current;
+  delete[] h_next;
+
   cudaFree(d_current);
   cudaFree(d_next);
 
@@ -27,8 +27,10 @@
 
 #include <experimental/mdspan>
 
+#include "aligned_accessor.hpp"
 #include "argparse/argparse.hpp"
 #include "commons.hpp"
+#include "heat_reference.hpp"
 
 // parameters
 struct args_params_t : public argparse::Args {
@@ -37,10 +39,19 @@ struct args_params_t : public argparse::Args {
   std::uint64_t& nx =
       kwarg("nx", "Local x dimension (of each partition)").set_default(10);
   std::uint64_t& nt = kwarg("nt", "Number of time steps").set_default(45);
+  std::uint64_t& reps =
+      kwarg("reps", "Number of runs, only the last one is timed (default: 1)")
+          .set_default(1);
   std::uint64_t& np = kwarg("np", "Number of partitions").set_default(10);
   bool& k = kwarg("k", "Heat transfer coefficient").set_default(0.5);
   double& dt = kwarg("dt", "Timestep unit (default: 1.0[s])").set_default(1.0);
   double& dx = kwarg("dx", "Local x dimension").set_default(1.0);
+  std::string& method =
+      kwarg("method", "explicit or spectral (default: explicit)")
+          .set_default("explicit");
+  bool& validate =
+      kwarg("validate", "print the max error against the spectral solution")
+          .set_default(false);
   bool& no_header =
       kwarg("no-header", "Do not print csv header row (default: false)")
           .set_default(false);
@@ -62,7 +73,7 @@ struct stepper {
   typedef double partition;
 
   // Our data for one time step
-  using view_1d = std::extents<int, std::dynamic_extent>;
+  using view_1d = std::extents<std::int64_t, std::dynamic_extent>;
   typedef std::mdspan<partition, view_1d, std::layout_right> space;
 
   void init_value(auto& data, std::size_t np, std::size_t nx) {
@@ -90,11 +101,15 @@ struct stepper {
     return id + dir;
   }
 
+  // the two time levels, kept across do_work calls
+  buffer_pair<partition> buffers;
+
   // do all the work on 'nx' data points for 'nt' time steps
   space do_work(std::size_t np, std::size_t nx, std::size_t nt) {
     std::size_t size = np * nx;
-    partition* current_ptr = new partition[size];
-    partition* next_ptr = new partition[size];
+    buffers.reserve(size);
+    partition* current_ptr = buffers[0];
+    partition* next_ptr = buffers[1];
     auto current = space(current_ptr, size);
     auto next = space(next_ptr, size);
 
@@ -112,6 +127,18 @@ struct stepper {
 
     return current;
   }
+
+  // the state after 'nt' time steps, from a single spectral solve
+  space spectral(std::size_t np, std::size_t nx, std::size_t nt) {
+    std::size_t size = np * nx;
+    buffers.reserve(size);
+    partition* current_ptr = buffers[0];
+
+    heat_reference(std::execution::seq, current_ptr, size, nt,
+                   k * dt / (dx * dx));
+
+    return space(current_ptr, size);
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -120,14 +147,27 @@ int benchmark(args_params_t const& args) {
   std::uint64_t nx = args.nx;  // Number of grid points.
   std::uint64_t nt = args.nt;  // Number of steps.
 
+  bool spectral = args.method == "spectral";
+  if (!spectral && args.method != "explicit")
+    std::cerr << "WARNING: unknown method '" << args.method
+              << "', using explicit" << std::endl;
+
   // Create the stepper object
   stepper step;
 
+  // Execute nt time steps on nx grid points, or jump to step nt at once
+  auto run = [&] {
+    return spectral ? step.spectral(np, nx, nt) : step.do_work(np, nx, nt);
+  };
+
+  // earlier runs warm up the stepper's buffers
+  for (std::uint64_t r = 1; r < args.reps; ++r)
+    run();
+
   // Measure execution time.
   Timer timer;
 
-  // Execute nt time steps on nx grid points.
-  auto solution = step.do_work(np, nx, nt);
+  auto solution = run();
   auto time = timer.stop();
 
   // Print the final solution
@@ -141,6 +181,12 @@ int benchmark(args_params_t const& args) {
     }
   }
 
+  if (args.validate) {
+    validate_heat(
+        std::execution::seq, [&](std::size_t i) { return solution[i]; },
+        np * nx, nt, k * dt / (dx * dx));
+  }
+
   if (args.time) {
     std::cout << "Duration: " << time << " ms."
               << "\n";
@@ -28,6 +28,7 @@
 // This example provides a stdpar implementation for the 1D stencil code.
 
 #include <thrust/device_vector.h>
+#include <thrust/host_vector.h>
 
 #include <exec/any_sender_of.hpp>
 #include <exec/static_thread_pool.hpp>
@@ -37,6 +38,7 @@
 
 #include "argparse/argparse.hpp"
 #include "commons.hpp"
+#include "heat_reference.hpp"
 
 // parameters
 struct args_params_t : public argparse::Args {
@@ -49,6 +51,9 @@ struct args_params_t : public argparse::Args {
   bool& k = kwarg("k", "Heat transfer coefficient").set_default(0.5);
   double& dt = kwarg("dt", "Timestep unit (default: 1.0[s])").set_default(1.0);
   double& dx = kwarg("dx", "Local x dimension").set_default(1.0);
+  bool& validate =
+      kwarg("validate", "print the max error against the spectral solution")
+          .set_default(false);
   bool& no_header =
       kwarg("no-header", "Do not print csv header row (default: false)")
           .set_default(false);
@@ -166,6 +171,14 @@ int benchmark(args_params_t const& args) {
     }
   }
 
+  if (args.validate) {
+    // one copy to the host instead of a device read per point
+    thrust::host_vector<double> host = solution;
+    validate_heat(
+        std::execution::seq, [&](std::size_t i) { return host[i]; }, np * nx,
+        nt, k * dt / (dx * dx));
+  }
+
   if (args.time) {
     std::cout << "Duration: " << time << " ms."
               << "\n";
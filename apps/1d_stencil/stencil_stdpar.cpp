@@ -29,8 +29,10 @@
 
 #include <experimental/mdspan>
 
+#include "aligned_accessor.hpp"
 #include "argparse/argparse.hpp"
 #include "commons.hpp"
+#include "heat_reference.hpp"
 
 // parameters
 struct args_params_t : public argparse::Args {
@@ -39,10 +41,25 @@ struct args_params_t : public argparse::Args {
   std::uint64_t& nx =
       kwarg("nx", "Local x dimension (of each partition)").set_default(10);
   std::uint64_t& nt = kwarg("nt", "Number of time steps").set_default(45);
+  std::uint64_t& reps =
+      kwarg("reps", "Number of runs, only the last one is timed (default: 1)")
+          .set_default(1);
   std::uint64_t& np = kwarg("np", "Number of partitions").set_default(10);
   bool& k = kwarg("k", "Heat transfer coefficient").set_default(0.5);
   double& dt = kwarg("dt", "Timestep unit (default: 1.0[s])").set_default(1.0);
   double& dx = kwarg("dx", "Local x dimension").set_default(1.0);
+  std::uint64_t& nfields =
+      kwarg("nfields", "Number of fields advanced together (default: 1)")
+          .set_default(1);
+  std::string& layout =
+      kwarg("layout", "Field storage: soa or interleaved (default: soa)")
+          .set_default("soa");
+  std::string& method =
+      kwarg("method", "explicit or spectral (default: explicit)")
+          .set_default("explicit");
+  bool& validate =
+      kwarg("validate", "print the max error against the spectral solution")
+          .set_default(false);
   bool& no_header =
       kwarg("no-header", "Do not print csv header row (default: false)")
           .set_default(false);
@@ -64,70 +81,262 @@ struct stepper {
   typedef double partition;
 
   // Our data for one time step
-  using view_1d = std::extents<int, std::dynamic_extent>;
-  typedef std::mdspan<partition, view_1d, std::layout_right> space;
+  using view_1d = std::extents<std::int64_t, std::dynamic_extent>;
+  typedef std::mdspan<partition, view_1d, std::layout_right,
+                      aligned_accessor<partition>>
+      space;
 
   // Our operator
-  double heat(double left, double middle, double right, const double k = ::k,
-              const double dt = ::dt, const double dx = ::dx) {
+  static double heat(double left, double middle, double right,
+                     const double k = ::k, const double dt = ::dt,
+                     const double dx = ::dx) {
     return middle + (k * dt / (dx * dx)) * (left - 2 * middle + right);
   }
 
-  inline std::size_t idx(std::size_t id, int dir, std::size_t size) {
-    if (id == 0 && dir == -1) {
-      return size - 1;
-    }
+  // the two periodic boundary points, peeled from the interior loop
+  void boundaries(space current, space next, std::size_t size) {
+    if (size == 0)
+      return;
 
-    if (id == size - 1 && dir == +1) {
-      return (std::size_t)0;
+    std::size_t last = size - 1;
+    if (size == 1) {
+      next[0] = heat(current[0], current[0], current[0]);
+      return;
     }
-    assert(id < size);
 
-    return id + dir;
+    next[0] = heat(current[last], current[0], current[1]);
+    next[last] = heat(current[last - 1], current[last], current[0]);
   }
 
+  // the two time levels, kept across do_work calls
+  buffer_pair<partition> buffers;
+
   // do all the work on 'nx' data points for 'nt' time steps
   space do_work(std::size_t np, std::size_t nx, std::size_t nt) {
     std::size_t size = np * nx;
-    partition* current_ptr = new partition[size];
-    partition* next_ptr = new partition[size];
+    buffers.reserve(size);
+    partition* current_ptr = buffers[0];
+    partition* next_ptr = buffers[1];
 
     auto current = space(current_ptr, size);
     auto next = space(next_ptr, size);
     // parallel init
-    std::for_each_n(std::execution::par, counting_iterator(0), np * nx,
-                    [=](std::size_t i) { current_ptr[i] = (double)i; });
+    for_each_index(std::execution::par, np * nx,
+                   [=](std::size_t i) { current_ptr[i] = (double)i; });
 
     // Actual time step loop
     for (std::size_t t = 0; t != nt; ++t) {
-      std::for_each_n(std::execution::par, counting_iterator(0), np * nx,
-                      [=, k = k, dt = dt, dx = dx](int32_t i) {
-                        auto left = idx(i, -1, size);
-                        auto right = idx(i, +1, size);
-                        next[i] = heat(current[left], current[i],
-                                       current[right], k, dt, dx);
-                      });
+      // interior points: no periodic wrap, so the loop vectorizes
+      for_each_index(std::execution::par_unseq, size > 2 ? size - 2 : 0,
+                     [=, this, k = k, dt = dt, dx = dx](std::size_t j) {
+                       std::size_t i = j + 1;
+                       next[i] = heat(current[i - 1], current[i],
+                                      current[i + 1], k, dt, dx);
+                     });
+      boundaries(current, next, size);
       std::swap(current, next);
     }
 
     return current;
   }
+
+  // nfields fields on the same grid: U(f, i). the soa layout keeps each field
+  // contiguous; the interleaved layout stores the fields of a grid point next
+  // to each other
+  using view_2d =
+      std::extents<std::int64_t, std::dynamic_extent, std::dynamic_extent>;
+  template <typename Layout>
+  using fields =
+      std::mdspan<partition, view_2d, Layout, aligned_accessor<partition>>;
+  using soa = std::layout_right;
+  using interleaved = std::layout_left;
+
+  // next[i] = heat(current) for i in [first, last). the two time levels never
+  // overlap; the restrict qualifiers tell the compiler so, and the loop
+  // vectorizes without a runtime overlap check
+  static void interior(partition* __restrict next,
+                       const partition* __restrict current, std::size_t first,
+                       std::size_t last, double k, double dt, double dx) {
+    for (std::size_t i = first; i < last; ++i)
+      next[i] = heat(current[i - 1], current[i], current[i + 1], k, dt, dx);
+  }
+
+  // interior for nf interleaved fields: next(f, i) at i * nf + f
+  static void interior_fields(partition* __restrict next,
+                              const partition* __restrict current,
+                              std::size_t nf, std::size_t first,
+                              std::size_t last, double k, double dt,
+                              double dx) {
+    for (std::size_t i = first; i < last; ++i)
+      for (std::size_t f = 0; f < nf; ++f)
+        next[i * nf + f] = heat(current[(i - 1) * nf + f], current[i * nf + f],
+                                current[(i + 1) * nf + f], k, dt, dx);
+  }
+
+  // next = heat(current) for every field on partition p. the innermost loop
+  // runs over contiguous data: grid points for soa, fields for interleaved.
+  // partition 0 also updates the periodic boundary points. the coefficients
+  // are passed in so that the kernel does not read the host globals
+  template <typename Layout>
+  static void update_fields(fields<Layout> current, fields<Layout> next,
+                            std::size_t p, std::size_t np, std::size_t nx,
+                            double k, double dt, double dx) {
+    std::size_t nf = current.extent(0);
+    std::size_t size = np * nx;
+    std::size_t first = std::max<std::size_t>(p * nx, 1);
+    std::size_t last = std::min<std::size_t>((p + 1) * nx, size - 1);
+
+    if constexpr (std::is_same_v<Layout, soa>) {
+      for (std::size_t f = 0; f < nf; ++f)
+        interior(&next(f, 0), &current(f, 0), first, last, k, dt, dx);
+    } else {
+      interior_fields(&next(0, 0), &current(0, 0), nf, first, last, k, dt,
+                      dx);
+    }
+
+    if (p != 0)
+      return;
+
+    for (std::size_t f = 0; f < nf; ++f) {
+      std::size_t l = size - 1;
+      std::size_t r = size > 1 ? 1 : 0;
+      next(f, 0) =
+          heat(current(f, l), current(f, 0), current(f, r), k, dt, dx);
+      if (size > 1)
+        next(f, l) =
+            heat(current(f, l - 1), current(f, l), current(f, 0), k, dt, dx);
+    }
+  }
+
+  // advance 'nfields' fields on 'np * nx' data points for 'nt' time steps,
+  // one task per partition for all fields. field f starts at i + f
+  template <typename Layout>
+  fields<Layout> do_work_fields(std::size_t nfields, std::size_t np,
+                                std::size_t nx, std::size_t nt) {
+    std::size_t size = np * nx;
+    buffers.reserve(nfields * size);
+
+    auto current = fields<Layout>(buffers[0], nfields, size);
+    auto next = fields<Layout>(buffers[1], nfields, size);
+    // parallel init
+    for_each_index(std::execution::par, nfields * size, [=](std::size_t n) {
+      std::size_t f = n / size;
+      std::size_t i = n % size;
+      current(f, i) = (double)(i + f);
+    });
+
+    // Actual time step loop
+    for (std::size_t t = 0; t != nt && size != 0; ++t) {
+      for_each_index(std::execution::par, np,
+                     [=, k = k, dt = dt, dx = dx](std::size_t p) {
+                       update_fields<Layout>(current, next, p, np, nx, k, dt,
+                                             dx);
+                     });
+      std::swap(current, next);
+    }
+
+    return current;
+  }
+
+  // the state after 'nt' time steps, from a single spectral solve
+  space spectral(std::size_t np, std::size_t nx, std::size_t nt) {
+    std::size_t size = np * nx;
+    buffers.reserve(size);
+    partition* current_ptr = buffers[0];
+
+    heat_reference(std::execution::par, current_ptr, size, nt,
+                   k * dt / (dx * dx));
+
+    return space(current_ptr, size);
+  }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
+template <typename Layout>
+int benchmark_fields(args_params_t const& args) {
+  std::uint64_t nf = args.nfields;  // Number of fields.
+  std::uint64_t np = args.np;       // Number of partitions.
+  std::uint64_t nx = args.nx;       // Number of grid points.
+  std::uint64_t nt = args.nt;       // Number of steps.
+
+  if (args.method != "explicit")
+    std::cerr << "WARNING: --nfields and --layout use the explicit method"
+              << std::endl;
+
+  // Create the stepper object
+  stepper step;
+
+  // earlier runs warm up the stepper's buffers
+  for (std::uint64_t r = 1; r < args.reps; ++r)
+    step.do_work_fields<Layout>(nf, np, nx, nt);
+
+  // Measure execution time.
+  Timer timer;
+
+  // Execute nt time steps of nf fields on nx grid points.
+  auto solution = step.do_work_fields<Layout>(nf, np, nx, nt);
+  auto time = timer.stop();
+
+  // Print the final solution
+  if (args.results) {
+    for (std::size_t f = 0; f != nf; ++f) {
+      for (std::size_t i = 0; i != np; ++i) {
+        std::cout << "F[" << f << "] U[" << i << "] = {";
+        for (std::size_t j = 0; j != nx; ++j) {
+          std::cout << solution(f, i * nx + j) << " ";
+        }
+        std::cout << "}\n";
+      }
+    }
+  }
+
+  // field f is field 0 shifted by f, which the heat operator preserves
+  if (args.validate) {
+    std::vector<double> exact(np * nx);
+    heat_reference(std::execution::par, exact.data(), np * nx, nt,
+                   k * dt / (dx * dx));
+    double error = 0;
+    for (std::size_t f = 0; f != nf; ++f)
+      error = std::max(
+          error,
+          max_error([&](std::size_t i) { return solution(f, i); }, exact, f));
+    print_error(error);
+  }
+
+  if (args.time) {
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+  }
+
+  return 0;
+}
+
 int benchmark(args_params_t const& args) {
   std::uint64_t np = args.np;  // Number of partitions.
   std::uint64_t nx = args.nx;  // Number of grid points.
   std::uint64_t nt = args.nt;  // Number of steps.
 
+  bool spectral = args.method == "spectral";
+  if (!spectral && args.method != "explicit")
+    std::cerr << "WARNING: unknown method '" << args.method
+              << "', using explicit" << std::endl;
+
   // Create the stepper object
   stepper step;
 
+  // Execute nt time steps on nx grid points, or jump to step nt at once
+  auto run = [&] {
+    return spectral ? step.spectral(np, nx, nt) : step.do_work(np, nx, nt);
+  };
+
+  // earlier runs warm up the stepper's buffers
+  for (std::uint64_t r = 1; r < args.reps; ++r)
+    run();
+
   // Measure execution time.
   Timer timer;
 
-  // Execute nt time steps on nx grid points.
-  auto solution = step.do_work(np, nx, nt);
+  auto solution = run();
   auto time = timer.stop();
 
   // Print the final solution
@@ -141,6 +350,12 @@ int benchmark(args_params_t const& args) {
     }
   }
 
+  if (args.validate) {
+    validate_heat(
+        std::execution::par, [&](std::size_t i) { return solution[i]; },
+        np * nx, nt, k * dt / (dx * dx));
+  }
+
   if (args.time) {
     std::cout << "Duration: " << time << " ms."
               << "\n";
@@ -158,6 +373,15 @@ int main(int argc, char* argv[]) {
     return 0;
   }
 
+  if (args.nfields > 1 || args.layout != "soa") {
+    if (args.layout == "interleaved")
+      return benchmark_fields<stepper::interleaved>(args);
+    if (args.layout != "soa")
+      std::cerr << "WARNING: unknown layout '" << args.layout
+                << "', using soa" << std::endl;
+    return benchmark_fields<stepper::soa>(args);
+  }
+
   benchmark(args);
 
   return 0;
@@ -0,0 +1,247 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//
+// This example provides a dataflow implementation for the 1D stencil code.
+// There is no global barrier between time steps: partition p computes step
+// t + 1 as soon as partitions p - 1, p and p + 1 are done with step t.
+
+#include <exec/async_scope.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <experimental/mdspan>
+#include <stdexec/execution.hpp>
+
+#include <atomic>
+
+#include "aligned_accessor.hpp"
+#include "argparse/argparse.hpp"
+#include "chunked_bulk.hpp"
+#include "commons.hpp"
+#include "heat_reference.hpp"
+
+// parameters
+struct args_params_t : public argparse::Args {
+  bool& results = kwarg("results", "print generated results (default: false)")
+                      .set_default(false);
+  std::uint64_t& nx =
+      kwarg("nx", "Local x dimension (of each partition)").set_default(10);
+  std::uint64_t& nt = kwarg("nt", "Number of time steps").set_default(45);
+  std::uint64_t& reps =
+      kwarg("reps", "Number of runs, only the last one is timed (default: 1)")
+          .set_default(1);
+  std::uint64_t& np = kwarg("np", "Number of partitions").set_default(10);
+  std::uint64_t& threads =
+      kwarg("threads", "Number of worker threads (default: 0, one per core)")
+          .set_default(0);
+  bool& k = kwarg("k", "Heat transfer coefficient").set_default(0.5);
+  double& dt = kwarg("dt", "Timestep unit (default: 1.0[s])").set_default(1.0);
+  double& dx = kwarg("dx", "Local x dimension").set_default(1.0);
+  bool& validate =
+      kwarg("validate", "print the max error against the spectral solution")
+          .set_default(false);
+  bool& no_header =
+      kwarg("no-header", "Do not print csv header row (default: false)")
+          .set_default(false);
+  bool& help = flag("h, help", "print help");
+  bool& time = kwarg("t, time", "print time").set_default(true);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Command-line variables
+bool header = true;  // print csv heading
+double k = 0.5;      // heat transfer coefficient
+double dt = 1.;      // time step
+double dx = 1.;      // grid spacing
+
+///////////////////////////////////////////////////////////////////////////////
+//[stepper_1
+struct stepper {
+  // Our partition type
+  typedef double partition;
+
+  // Our data for one time step: np partitions of nx cells and 2 ghost cells
+  using view_2d =
+      std::extents<std::int64_t, std::dynamic_extent, std::dynamic_extent>;
+  typedef std::mdspan<partition, view_2d, std::layout_right,
+                      aligned_accessor<partition>>
+      space;
+
+  // Our operator
+  double heat(double left, double middle, double right, const double k = ::k,
+              const double dt = ::dt, const double dx = ::dx) {
+    return middle + (k * dt / (dx * dx)) * (left - 2 * middle + right);
+  }
+
+  std::size_t np = 0;
+  std::size_t nx = 0;
+  std::size_t nt = 0;
+
+  // U[t % 2] holds step t
+  std::array<space, 2> U;
+
+  // storage of U, kept across do_work calls
+  buffer_pair<partition> buffers;
+
+  // deps[2 * p + t % 2]: neighbours of p yet to finish step t. at most two
+  // steps of a partition are pending at any time
+  std::unique_ptr<std::atomic<int>[]> deps;
+
+  // tasks in flight
+  exec::async_scope scope;
+
+  // partition p computes step t + 1 from step t of p - 1, p and p + 1, then
+  // releases its neighbours
+  void update(auto sch, std::size_t p, std::size_t t) {
+    auto current = U[t % 2];
+    auto next = U[(t + 1) % 2];
+    std::size_t left = (p + np - 1) % np;
+    std::size_t right = (p + 1) % np;
+
+    // ghost cells (periodic domain)
+    current(p, 0) = current(left, nx);
+    current(p, nx + 1) = current(right, 1);
+
+    for (std::size_t j = 1; j <= nx; ++j)
+      next(p, j) = heat(current(p, j - 1), current(p, j), current(p, j + 1), k,
+                        dt, dx);
+
+    if (t + 1 == nt)
+      return;
+
+    for (std::size_t q : {left, p, right})
+      release(sch, q, t + 1);
+  }
+
+  // one neighbour of q finished step t. the last one spawns q's step t + 1
+  void release(auto sch, std::size_t q, std::size_t t) {
+    auto& count = deps[2 * q + t % 2];
+    if (count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      count.store(3, std::memory_order_relaxed);
+      spawn(sch, q, t);
+    }
+  }
+
+  void spawn(auto sch, std::size_t p, std::size_t t) {
+    scope.spawn(stdexec::schedule(sch) |
+                stdexec::then([=, this] { update(sch, p, t); }));
+  }
+
+  // do all the work on 'nx' data points for 'nt' time steps
+  space do_work(auto sch, std::size_t np, std::size_t nx, std::size_t nt) {
+    this->np = np;
+    this->nx = nx;
+    this->nt = nt;
+
+    std::size_t size = np * (nx + 2);
+    buffers.reserve(size);
+    for (int i = 0; i < 2; ++i)
+      U[i] = space(buffers[i], np, nx + 2);
+
+    deps = std::make_unique<std::atomic<int>[]>(2 * np);
+    for (std::size_t i = 0; i < 2 * np; ++i)
+      deps[i].store(3, std::memory_order_relaxed);
+
+    // parallel init
+    auto current = U[0];
+    for_each_index(std::execution::par, np * nx, [=](std::size_t i) {
+      current(i / nx, 1 + i % nx) = (double)i;
+    });
+
+    if (nt == 0)
+      return U[0];
+
+    // step 0 is available everywhere
+    for (std::size_t p = 0; p < np; ++p)
+      spawn(sch, p, 0);
+
+    stdexec::sync_wait(scope.on_empty());
+
+    return U[nt % 2];
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+int benchmark(args_params_t const& args) {
+  std::uint64_t np = args.np;  // Number of partitions.
+  std::uint64_t nx = args.nx;  // Number of grid points.
+  std::uint64_t nt = args.nt;  // Number of steps.
+
+  // Create the stepper object
+  stepper step;
+
+  std::size_t nthreads = worker_count(args.threads);
+
+  exec::static_thread_pool pool(nthreads);
+  stdexec::scheduler auto sch = pool.get_scheduler();
+
+  // earlier runs warm up the stepper's buffers
+  for (std::uint64_t r = 1; r < args.reps; ++r)
+    step.do_work(sch, np, nx, nt);
+
+  // Measure execution time.
+  Timer timer;
+
+  stepper::space solution = step.do_work(sch, np, nx, nt);
+
+  auto time = timer.stop();
+
+  // Print the final solution
+  if (args.results) {
+    for (std::size_t i = 0; i != np; ++i) {
+      std::cout << "U[" << i << "] = {";
+      for (std::size_t j = 0; j != nx; ++j) {
+        std::cout << solution(i, j + 1) << " ";
+      }
+      std::cout << "}\n";
+    }
+  }
+
+  if (args.validate) {
+    // partition p holds its points at (p, 1 .. nx)
+    auto u = [&](std::size_t i) { return solution(i / nx, i % nx + 1); };
+    validate_heat(std::execution::par, u, np * nx, nt, k * dt / (dx * dx));
+  }
+
+  if (args.time) {
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+  }
+
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  // parse params
+  args_params_t args = argparse::parse<args_params_t>(argc, argv);
+  // see if help wanted
+  if (args.help) {
+    args.print();  // prints all variables
+    return 0;
+  }
+
+  benchmark(args);
+
+  return 0;
+}
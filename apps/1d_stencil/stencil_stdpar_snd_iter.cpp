@@ -32,8 +32,11 @@
 #include <experimental/mdspan>
 #include <stdexec/execution.hpp>
 
+#include "aligned_accessor.hpp"
 #include "argparse/argparse.hpp"
+#include "chunked_bulk.hpp"
 #include "commons.hpp"
+#include "heat_reference.hpp"
 
 // parameters
 struct args_params_t : public argparse::Args {
@@ -42,10 +45,19 @@ struct args_params_t : public argparse::Args {
   std::uint64_t& nx =
       kwarg("nx", "Local x dimension (of each partition)").set_default(10);
   std::uint64_t& nt = kwarg("nt", "Number of time steps").set_default(45);
+  std::uint64_t& reps =
+      kwarg("reps", "Number of runs, only the last one is timed (default: 1)")
+          .set_default(1);
   std::uint64_t& np = kwarg("np", "Number of partitions").set_default(10);
+  std::uint64_t& threads =
+      kwarg("threads", "Number of worker threads (default: 0, one per core)")
+          .set_default(0);
   bool& k = kwarg("k", "Heat transfer coefficient").set_default(0.5);
   double& dt = kwarg("dt", "Timestep unit (default: 1.0[s])").set_default(1.0);
   double& dx = kwarg("dx", "Local x dimension").set_default(1.0);
+  bool& validate =
+      kwarg("validate", "print the max error against the spectral solution")
+          .set_default(false);
   bool& no_header =
       kwarg("no-header", "Do not print csv header row (default: false)")
           .set_default(false);
@@ -71,60 +83,90 @@ struct stepper {
   typedef double partition;
 
   // Our data for one time step
-  using view_1d = std::extents<int, std::dynamic_extent>;
-  typedef std::mdspan<partition, view_1d, std::layout_right> space;
+  using view_1d = std::extents<std::int64_t, std::dynamic_extent>;
+  typedef std::mdspan<partition, view_1d, std::layout_right,
+                      aligned_accessor<partition>>
+      space;
 
   // Our operator
-  double heat(double left, double middle, double right, const double k = ::k,
-              const double dt = ::dt, const double dx = ::dx) {
+  static double heat(double left, double middle, double right,
+                     const double k = ::k, const double dt = ::dt,
+                     const double dx = ::dx) {
     return middle + (k * dt / (dx * dx)) * (left - 2 * middle + right);
   }
 
-  inline std::size_t idx(std::size_t id, int dir, std::size_t size) {
-    if (id == 0 && dir == -1) {
-      return size - 1;
-    }
+  // next[i] = heat(current) for i in [first, last). the two time levels never
+  // overlap; the restrict qualifiers tell the compiler so, and the loop
+  // vectorizes without a runtime overlap check
+  static void interior(partition* __restrict next,
+                       const partition* __restrict current, std::size_t first,
+                       std::size_t last, double k, double dt, double dx) {
+    for (std::size_t i = first; i < last; ++i)
+      next[i] = heat(current[i - 1], current[i], current[i + 1], k, dt, dx);
+  }
+
+  // the two periodic boundary points, peeled from the interior loop
+  void boundaries(space current, space next, std::size_t size) {
+    if (size == 0)
+      return;
 
-    if (id == size - 1 && dir == +1) {
-      return (std::size_t)0;
+    std::size_t last = size - 1;
+    if (size == 1) {
+      next[0] = heat(current[0], current[0], current[0]);
+      return;
     }
-    assert(id < size);
 
-    return id + dir;
+    next[0] = heat(current[last], current[0], current[1]);
+    next[last] = heat(current[last - 1], current[last], current[0]);
+  }
+
+  // next = heat(current) on partition i. runs inside a bulk task, so the
+  // interior loop is serial; it has no periodic wrap and vectorizes.
+  // partition 0 also updates the two boundary points
+  void update(space current, space next, std::size_t i, std::size_t np,
+              std::size_t nx) {
+    std::size_t size = np * nx;
+    std::size_t first = std::max<std::size_t>(i * nx, 1);
+    std::size_t last = std::min<std::size_t>((i + 1) * nx, size - 1);
+
+    interior(next.data_handle(), current.data_handle(), first, last, k, dt,
+             dx);
+
+    if (i == 0)
+      boundaries(current, next, size);
   }
 
-  partition* current_ptr = nullptr;
-  partition* next_ptr = nullptr;
-  space current;
-  space next;
+  // bulk workers and the cursor they share the partitions through
+  std::size_t nworkers = 1;
+  chunk_counter chunks;
+
+  // the two time levels, kept across do_work calls
+  buffer_pair<partition> buffers;
 
   // do all the work on 'nx' data points for 'nt' time steps
   space do_work(stdexec::scheduler auto& sch, std::size_t np, std::size_t nx,
                 std::size_t nt) {
     std::size_t size = np * nx;
-    partition* current_ptr = new partition[size];
-    partition* next_ptr = new partition[size];
-
-    auto current = space(current_ptr, size);
-    auto next = space(next_ptr, size);
+    buffers.reserve(size);
+    auto current = space(buffers[0], size);
+    auto next = space(buffers[1], size);
     // parallel init
-    std::for_each_n(std::execution::par, counting_iterator(0), np * nx,
-                    [=](std::size_t i) { current(i) = (double)i; });
+    for_each_index(std::execution::par, np * nx,
+                   [=](std::size_t i) { current(i) = (double)i; });
+
+    // nworkers bulk tasks share the np partitions in chunks
+    std::size_t grain = chunk_grain(np, nworkers);
 
     // Actual time step loop
     for (std::size_t t = 0; t != nt; ++t) {
+      chunks.reset();
       auto sender =
-          stdexec::transfer_just(sch, current, next, k, dt, dx, np, nx) |
-          stdexec::bulk(np, [&](int i, auto& current, auto& next, auto k,
-                                auto dt, auto dx, auto np, auto nx) {
-            std::for_each_n(std::execution::par, counting_iterator(0), nx,
-                            [=](std::size_t j) {
-                              std::size_t id = i * nx + j;
-                              auto left = idx(id, -1, np * nx);
-                              auto right = idx(id, +1, np * nx);
-                              next(id) = heat(current(left), current(id),
-                                              current(right), k, dt, dx);
-                            });
+          stdexec::transfer_just(sch, current, next, np, nx) |
+          stdexec::bulk(nworkers, [&](std::size_t, auto& current, auto& next,
+                                      auto np, auto nx) {
+            chunks.run(np, grain, [&](std::size_t i) {
+              update(current, next, i, np, nx);
+            });
           });
       stdexec::sync_wait(std::move(sender));
       std::swap(current, next);
@@ -143,8 +185,15 @@ int benchmark(args_params_t const& args) {
   // Create the stepper object
   stepper step;
 
-  exec::static_thread_pool pool(np);
+  std::size_t nthreads = worker_count(args.threads);
+
+  exec::static_thread_pool pool(nthreads);
   stdexec::scheduler auto sch = pool.get_scheduler();
+  step.nworkers = nthreads;
+
+  // earlier runs warm up the stepper's buffers
+  for (std::uint64_t r = 1; r < args.reps; ++r)
+    step.do_work(sch, np, nx, nt);
 
   // Measure execution time.
   Timer timer;
@@ -164,6 +213,12 @@ int benchmark(args_params_t const& args) {
     }
   }
 
+  if (args.validate) {
+    validate_heat(
+        std::execution::par, [&](std::size_t i) { return solution[i]; },
+        np * nx, nt, k * dt / (dx * dx));
+  }
+
   if (args.time) {
     std::cout << "Duration: " << time << " ms."
               << "\n";
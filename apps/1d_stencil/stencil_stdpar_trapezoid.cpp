@@ -0,0 +1,288 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//
+// This example provides a cache-oblivious stdpar implementation for the 1D
+// stencil code. The space-time domain is recursively cut into trapezoids
+// (Frigo and Strumpen) so that each level of the memory hierarchy reuses the
+// cells it holds across several time steps. Independent trapezoids are forked
+// onto a stdexec thread pool, so the recursion itself stays on the host.
+
+#include <exec/async_scope.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <experimental/mdspan>
+#include <stdexec/execution.hpp>
+
+#include "aligned_accessor.hpp"
+#include "argparse/argparse.hpp"
+#include "chunked_bulk.hpp"
+#include "commons.hpp"
+#include "fork_join.hpp"
+#include "heat_reference.hpp"
+
+// parameters
+struct args_params_t : public argparse::Args {
+  bool& results = kwarg("results", "print generated results (default: false)")
+                      .set_default(false);
+  std::uint64_t& nx =
+      kwarg("nx", "Local x dimension (of each partition)").set_default(10);
+  std::uint64_t& nt = kwarg("nt", "Number of time steps").set_default(45);
+  std::uint64_t& reps =
+      kwarg("reps", "Number of runs, only the last one is timed (default: 1)")
+          .set_default(1);
+  std::uint64_t& np = kwarg("np", "Number of partitions").set_default(10);
+  std::uint64_t& threads =
+      kwarg("threads", "Number of worker threads (default: 0, one per core)")
+          .set_default(0);
+  bool& k = kwarg("k", "Heat transfer coefficient").set_default(0.5);
+  double& dt = kwarg("dt", "Timestep unit (default: 1.0[s])").set_default(1.0);
+  double& dx = kwarg("dx", "Local x dimension").set_default(1.0);
+  bool& validate =
+      kwarg("validate", "print the max error against the spectral solution")
+          .set_default(false);
+  bool& no_header =
+      kwarg("no-header", "Do not print csv header row (default: false)")
+          .set_default(false);
+  bool& help = flag("h, help", "print help");
+  bool& time = kwarg("t, time", "print time").set_default(true);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Command-line variables
+bool header = true;  // print csv heading
+double k = 0.5;      // heat transfer coefficient
+double dt = 1.;      // time step
+double dx = 1.;      // grid spacing
+
+///////////////////////////////////////////////////////////////////////////////
+//[stepper_1
+struct stepper {
+  // Our partition type
+  typedef double partition;
+
+  // Our data for one time step
+  using view_1d = std::extents<std::int64_t, std::dynamic_extent>;
+  typedef std::mdspan<partition, view_1d, std::layout_right,
+                      aligned_accessor<partition>>
+      space;
+
+  // trapezoids with fewer cells are computed row by row. this only bounds the
+  // recursion overhead; it is far below any cache size
+  static constexpr std::int64_t base_cells = 256;
+
+  // trapezoids with fewer cells are not split into parallel tasks
+  static constexpr std::int64_t task_cells = 1 << 14;
+
+  // Our operator
+  double heat(double left, double middle, double right, const double k = ::k,
+              const double dt = ::dt, const double dx = ::dx) {
+    return middle + (k * dt / (dx * dx)) * (left - 2 * middle + right);
+  }
+
+  inline std::size_t idx(std::size_t id, int dir, std::size_t size) {
+    if (id == 0 && dir == -1) {
+      return size - 1;
+    }
+
+    if (id == size - 1 && dir == +1) {
+      return (std::size_t)0;
+    }
+    assert(id < size);
+
+    return id + dir;
+  }
+
+  // U[t % 2] holds step t
+  std::array<space, 2> U;
+  std::int64_t size = 0;
+
+  // step t + 1 of the cells [b, e), 0 <= b <= e <= size. only the two end
+  // points wrap, so the interior run has no branches
+  void strip(std::int64_t t, std::int64_t b, std::int64_t e) {
+    auto current = U[t % 2];
+    auto next = U[(t + 1) % 2];
+    // local copies: the globals could alias next, which would keep them
+    // from being hoisted out of the loop
+    const double k = ::k, dt = ::dt, dx = ::dx;
+    auto edge = [&](std::size_t i) {
+      next[i] = heat(current[idx(i, -1, size)], current[i],
+                     current[idx(i, +1, size)], k, dt, dx);
+    };
+
+    if (b == e)
+      return;
+    if (b == 0)
+      edge(0);
+
+    std::int64_t first = std::max<std::int64_t>(b, 1);
+    std::int64_t last = std::min<std::int64_t>(e, size - 1);
+    for (std::int64_t i = first; i < last; ++i)
+      next[i] = heat(current[i - 1], current[i], current[i + 1], k, dt, dx);
+
+    if (e == size && size > 1)
+      edge(size - 1);
+  }
+
+  // step t + 1 of the cells [x0, x1). x may exceed size in the trapezoids
+  // that wrap around the periodic boundary
+  void row(std::int64_t t, std::int64_t x0, std::int64_t x1) {
+    strip(t, std::min(x0, size), std::min(x1, size));
+    strip(t, std::max(x0, size) - size, std::max(x1, size) - size);
+  }
+
+  // tasks forked by walk
+  exec::async_scope scope;
+
+  // steps [t0, t1) of the trapezoid whose row t spans
+  // [x0 + dx0 * (t - t0), x1 + dx1 * (t - t0)), dx0 and dx1 in {-1, 0, 1}
+  void walk(stdexec::scheduler auto sch, std::int64_t t0, std::int64_t t1,
+            std::int64_t x0, int dx0, std::int64_t x1, int dx1) {
+    std::int64_t h = t1 - t0;
+    std::int64_t top0 = x0 + dx0 * h;
+    std::int64_t top1 = x1 + dx1 * h;
+    std::int64_t cells = ((x1 - x0) + (top1 - top0)) * h / 2;
+
+    if (h == 1 || cells <= base_cells) {
+      for (std::int64_t t = t0; t < t1; ++t)
+        row(t, x0 + dx0 * (t - t0), x1 + dx1 * (t - t0));
+    } else if (x1 - x0 >= 2 * h && top1 - top0 >= 2 * h) {
+      // space cut: two independent upright trapezoids, then the inverted
+      // triangle between them
+      std::int64_t xm = (top0 + top1) / 2;
+      auto left = [=, this] { walk(sch, t0, t1, x0, dx0, xm, -1); };
+      auto right = [=, this] { walk(sch, t0, t1, xm, 1, x1, dx1); };
+
+      if (cells >= task_cells) {
+        fork_join(scope, sch, left, right);
+      } else {
+        left();
+        right();
+      }
+
+      walk(sch, t0, t1, xm, -1, xm, 1);
+    } else {
+      // time cut
+      std::int64_t s = h / 2;
+      walk(sch, t0, t0 + s, x0, dx0, x1, dx1);
+      walk(sch, t0 + s, t1, x0 + dx0 * s, dx0, x1 + dx1 * s, dx1);
+    }
+  }
+
+  // the two time levels, kept across do_work calls
+  buffer_pair<partition> buffers;
+
+  // do all the work on 'nx' data points for 'nt' time steps
+  space do_work(stdexec::scheduler auto sch, std::size_t np, std::size_t nx,
+                std::size_t nt) {
+    size = np * nx;
+    buffers.reserve(size);
+    partition* current_ptr = buffers[0];
+    partition* next_ptr = buffers[1];
+
+    U[0] = space(current_ptr, size);
+    U[1] = space(next_ptr, size);
+
+    // parallel init
+    for_each_index(std::execution::par, np * nx,
+                   [=](std::size_t i) { current_ptr[i] = (double)i; });
+
+    // the periodic domain is processed in slabs of at most size / 2 steps:
+    // an upright trapezoid over [0, size) followed by the inverted triangle
+    // that wraps around the boundary
+    std::int64_t h = std::max<std::int64_t>(size / 2, 1);
+    for (std::int64_t t0 = 0; t0 < (std::int64_t)nt; t0 += h) {
+      std::int64_t t1 = std::min<std::int64_t>(t0 + h, nt);
+      walk(sch, t0, t1, 0, 1, size, -1);
+      walk(sch, t0, t1, size, -1, size, 1);
+    }
+
+    // spawns whose trapezoid was taken back by the forking thread
+    stdexec::sync_wait(scope.on_empty());
+
+    return U[nt % 2];
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+int benchmark(args_params_t const& args) {
+  std::uint64_t np = args.np;  // Number of partitions.
+  std::uint64_t nx = args.nx;  // Number of grid points.
+  std::uint64_t nt = args.nt;  // Number of steps.
+
+  // Create the stepper object
+  stepper step;
+
+  exec::static_thread_pool pool(worker_count(args.threads));
+  stdexec::scheduler auto sch = pool.get_scheduler();
+
+  // earlier runs warm up the stepper's buffers
+  for (std::uint64_t r = 1; r < args.reps; ++r)
+    step.do_work(sch, np, nx, nt);
+
+  // Measure execution time.
+  Timer timer;
+
+  // Execute nt time steps on nx grid points.
+  auto solution = step.do_work(sch, np, nx, nt);
+  auto time = timer.stop();
+
+  // Print the final solution
+  if (args.results) {
+    for (std::size_t i = 0; i != np; ++i) {
+      std::cout << "U[" << i << "] = {";
+      for (std::size_t j = 0; j != nx; ++j) {
+        std::cout << solution[i * nx + j] << " ";
+      }
+      std::cout << "}\n";
+    }
+  }
+
+  if (args.validate) {
+    validate_heat(
+        std::execution::par, [&](std::size_t i) { return solution[i]; },
+        np * nx, nt, k * dt / (dx * dx));
+  }
+
+  if (args.time) {
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+  }
+
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  // parse params
+  args_params_t args = argparse::parse<args_params_t>(argc, argv);
+  // see if help wanted
+  if (args.help) {
+    args.print();  // prints all variables
+    return 0;
+  }
+
+  benchmark(args);
+
+  return 0;
+}
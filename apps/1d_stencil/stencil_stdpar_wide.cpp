@@ -0,0 +1,316 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//
+// This example provides a stdpar implementation for wide-radius 1D stencils
+// (higher-order diffusion, FIR-style filters). The radius is a template
+// parameter so that each task keeps a block of outputs and the neighbours they
+// share in registers; the coefficients can be set at runtime.
+
+#include <experimental/mdspan>
+#include <sstream>
+#include <stdexcept>
+
+#include "aligned_accessor.hpp"
+#include "argparse/argparse.hpp"
+#include "commons.hpp"
+#include "heat_reference.hpp"
+
+// parameters
+struct args_params_t : public argparse::Args {
+  bool& results = kwarg("results", "print generated results (default: false)")
+                      .set_default(false);
+  std::uint64_t& nx =
+      kwarg("nx", "Local x dimension (of each partition)").set_default(10);
+  std::uint64_t& nt = kwarg("nt", "Number of time steps").set_default(45);
+  std::uint64_t& reps =
+      kwarg("reps", "Number of runs, only the last one is timed (default: 1)")
+          .set_default(1);
+  std::uint64_t& np = kwarg("np", "Number of partitions").set_default(10);
+  bool& k = kwarg("k", "Heat transfer coefficient").set_default(0.5);
+  double& dt = kwarg("dt", "Timestep unit (default: 1.0[s])").set_default(1.0);
+  double& dx = kwarg("dx", "Local x dimension").set_default(1.0);
+  int& radius =
+      kwarg("radius", "Stencil radius, 1 to 8 (default: 1)").set_default(1);
+  std::string& coeffs =
+      kwarg("coeffs",
+            "2 * radius + 1 comma separated weights, leftmost first. sets the "
+            "radius (default: higher-order diffusion)")
+          .set_default("");
+  bool& validate =
+      kwarg("validate", "print the max error against the spectral solution")
+          .set_default(false);
+  bool& no_header =
+      kwarg("no-header", "Do not print csv header row (default: false)")
+          .set_default(false);
+  bool& help = flag("h, help", "print help");
+  bool& time = kwarg("t, time", "print time").set_default(true);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Command-line variables
+bool header = true;  // print csv heading
+double k = 0.5;      // heat transfer coefficient
+double dt = 1.;      // time step
+double dx = 1.;      // grid spacing
+
+// largest supported stencil radius
+constexpr int max_radius = 8;
+
+///////////////////////////////////////////////////////////////////////////////
+//[stepper_1
+struct stepper {
+  // Our partition type
+  typedef double partition;
+
+  // Our data for one time step
+  using view_1d = std::extents<std::int64_t, std::dynamic_extent>;
+  typedef std::mdspan<partition, view_1d, std::layout_right,
+                      aligned_accessor<partition>>
+      space;
+
+  template <int R>
+  using weights_t = std::array<double, 2 * R + 1>;
+
+  // outputs computed per task. with the loaded neighbours they fit in the
+  // vector registers of current CPUs
+  static constexpr std::int64_t block = 8;
+
+  // u + (k * dt / dx^2) * d2u/dx2 with the central difference of order 2 * R.
+  // R = 1 is the three-point heat operator of the other variants
+  template <int R>
+  static weights_t<R> diffusion(const double k = ::k, const double dt = ::dt,
+                                const double dx = ::dx) {
+    double a = k * dt / (dx * dx);
+    weights_t<R> w{};
+    double ratio = 1;  // (R!)^2 / ((R - j)! (R + j)!)
+    double center = 0;
+    for (int j = 1; j <= R; ++j) {
+      ratio *= double(R - j + 1) / double(R + j);
+      double c = (j % 2 ? 2. : -2.) * ratio / (j * j);
+      w[R - j] = w[R + j] = a * c;
+      center -= 2 * c;
+    }
+    w[R] = 1 + a * center;
+    return w;
+  }
+
+  // next[i] with the periodic wrap, for the points near the boundary
+  template <int R>
+  static double point(weights_t<R> const& w, space current, std::int64_t i,
+                      std::int64_t size) {
+    double sum = 0;
+    for (int j = 0; j < 2 * R + 1; ++j) {
+      std::int64_t x = ((i + j - R) % size + size) % size;
+      sum += w[j] * current[x];
+    }
+    return sum;
+  }
+
+  // next[i0, i0 + block) away from the boundary. every loaded neighbour is
+  // reused by up to 2 * R + 1 outputs, and the inner loop vectorizes across
+  // the block
+  template <int R>
+  static void block_kernel(weights_t<R> const& w, space current, space next,
+                           std::int64_t i0) {
+    double in[block + 2 * R];
+    double out[block] = {};
+
+    for (int b = 0; b < block + 2 * R; ++b)
+      in[b] = current[i0 - R + b];
+
+    for (int j = 0; j < 2 * R + 1; ++j)
+      for (int b = 0; b < block; ++b)
+        out[b] += w[j] * in[b + j];
+
+    for (int b = 0; b < block; ++b)
+      next[i0 + b] = out[b];
+  }
+
+  // the two time levels, kept across do_work calls
+  buffer_pair<partition> buffers;
+
+  // do all the work on 'nx' data points for 'nt' time steps
+  template <int R>
+  space do_work(weights_t<R> const& w, std::size_t np, std::size_t nx,
+                std::size_t nt) {
+    std::int64_t size = np * nx;
+    buffers.reserve(size);
+    partition* current_ptr = buffers[0];
+    partition* next_ptr = buffers[1];
+
+    auto current = space(current_ptr, size);
+    auto next = space(next_ptr, size);
+    // parallel init
+    for_each_index(std::execution::par, np * nx,
+                   [=](std::size_t i) { current_ptr[i] = (double)i; });
+
+    // the blocks cover [R, tail) and never wrap; the first R points and
+    // [tail, size) are done one by one
+    std::int64_t nblocks = size > 2 * R ? (size - 2 * R) / block : 0;
+    std::int64_t head = std::min<std::int64_t>(R, size);
+    std::int64_t tail = R + nblocks * block;
+
+    // Actual time step loop
+    for (std::size_t t = 0; t != nt; ++t) {
+      for_each_index(std::execution::par_unseq, nblocks,
+                     [=](std::int64_t b) {
+                       block_kernel<R>(w, current, next, R + b * block);
+                     });
+
+      for (std::int64_t i = 0; i < head; ++i)
+        next[i] = point<R>(w, current, i, size);
+      for (std::int64_t i = std::max(tail, head); i < size; ++i)
+        next[i] = point<R>(w, current, i, size);
+
+      std::swap(current, next);
+    }
+
+    return current;
+  }
+};
+
+// call f(std::integral_constant<int, r>) for r in [1, sizeof...(Rs)]
+template <int... Rs, typename F>
+bool dispatch_radius(std::integer_sequence<int, Rs...>, int r, F&& f) {
+  return ((r == Rs + 1 ? (f(std::integral_constant<int, Rs + 1>{}), true)
+                       : false) ||
+          ...);
+}
+
+// parse "w0,w1,..." into weights. a malformed list gives no weights, so that
+// the diffusion weights are used
+std::vector<double> to_weights(std::string const& list) {
+  std::vector<double> w;
+  std::stringstream ss(list);
+  std::string item;
+  try {
+    while (std::getline(ss, item, ',')) {
+      std::size_t end = 0;
+      w.push_back(std::stod(item, &end));
+      if (end != item.size())
+        throw std::invalid_argument(item);
+    }
+  } catch (std::logic_error const&) {
+    // std::invalid_argument or std::out_of_range
+    std::cerr << "WARNING: cannot parse \"" << item
+              << "\" in --coeffs, using the diffusion weights" << std::endl;
+    w.clear();
+  }
+  return w;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int benchmark(args_params_t const& args) {
+  std::uint64_t np = args.np;  // Number of partitions.
+  std::uint64_t nx = args.nx;  // Number of grid points.
+  std::uint64_t nt = args.nt;  // Number of steps.
+  int radius = args.radius;    // Stencil radius.
+
+  std::vector<double> coeffs = to_weights(args.coeffs);
+  if (!coeffs.empty()) {
+    if (coeffs.size() % 2 == 1 && coeffs.size() >= 3 &&
+        coeffs.size() <= std::size_t(2 * max_radius + 1)) {
+      radius = coeffs.size() / 2;
+    } else {
+      std::cerr << "WARNING: need an odd number of 3 to "
+                << 2 * max_radius + 1
+                << " weights in --coeffs, using the diffusion weights"
+                << std::endl;
+      coeffs.clear();
+    }
+  }
+
+  if (radius < 1 || radius > max_radius) {
+    std::cerr << "WARNING: radius " << radius << " not in [1, " << max_radius
+              << "], using " << std::clamp(radius, 1, max_radius) << std::endl;
+    radius = std::clamp(radius, 1, max_radius);
+  }
+
+  // Create the stepper object
+  stepper step;
+  stepper::space solution;
+  std::vector<double> weights;  // the weights in use
+  double time = 0;
+
+  dispatch_radius(
+      std::make_integer_sequence<int, max_radius>{}, radius, [&](auto r) {
+        constexpr int R = decltype(r)::value;
+        auto w = stepper::diffusion<R>();
+        if (!coeffs.empty())
+          std::copy(coeffs.begin(), coeffs.end(), w.begin());
+        weights.assign(w.begin(), w.end());
+
+        // earlier runs warm up the stepper's buffers
+        for (std::uint64_t rep = 1; rep < args.reps; ++rep)
+          step.do_work<R>(w, np, nx, nt);
+
+        // Measure execution time.
+        Timer timer;
+
+        // Execute nt time steps on nx grid points.
+        solution = step.do_work<R>(w, np, nx, nt);
+        time = timer.stop();
+      });
+
+  // Print the final solution
+  if (args.results) {
+    for (std::size_t i = 0; i != np; ++i) {
+      std::cout << "U[" << i << "] = {";
+      for (std::size_t j = 0; j != nx; ++j) {
+        std::cout << solution[i * nx + j] << " ";
+      }
+      std::cout << "}\n";
+    }
+  }
+
+  if (args.validate) {
+    std::vector<double> exact(np * nx);
+    stencil_reference(std::execution::par, exact.data(), np * nx, nt,
+                      weights.data(), weights.size() / 2);
+    print_error(max_error([&](std::size_t i) { return solution[i]; }, exact));
+  }
+
+  if (args.time) {
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+  }
+
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  // parse params
+  args_params_t args = argparse::parse<args_params_t>(argc, argv);
+  // see if help wanted
+  if (args.help) {
+    args.print();  // prints all variables
+    return 0;
+  }
+
+  benchmark(args);
+
+  return 0;
+}
@@ -33,24 +33,20 @@
 #include <vector>
 #include "argparse/argparse.hpp"
 #include "commons.hpp"
+#include "cholesky_solve.hpp"
 #include "matrixutil.hpp"
 
 using namespace std;
 
 struct solver {
 
-  using view_2d = std::extents<int, std::dynamic_extent, std::dynamic_extent>;
-
-  typedef std::mdspan<int, view_2d, std::layout_right> matrix_ms_t;
-
+  // returns L row-major, upper triangle zero
   template <typename T>
-  matrix_ms_t Cholesky_Decomposition(std::vector<T>& vec, int n) {
-    std::vector<T> lower(n * n, 0);
+  std::vector<T> Cholesky_Decomposition(matrix_storage<T>& vec, int n) {
+    std::vector<T> lower(std::size_t(n) * n, 0);
 
-    auto matrix_ms =
-        std::mdspan<T, view_2d, std::layout_right>(vec.data(), n, n);
-    auto lower_ms =
-        std::mdspan<T, view_2d, std::layout_right>(lower.data(), n, n);
+    auto matrix_ms = matrix_view<T>(vec.data(), n, n);
+    auto lower_ms = matrix_view<T>(lower.data(), n, n);
 
     // Decomposing a matrix into Lower Triangular
     for (int i = 0; i < matrix_ms.extent(0); i++) {
@@ -70,7 +66,7 @@ struct solver {
         }
       }
     }
-    return lower_ms;
+    return lower;
   }
 };
 
@@ -79,14 +75,17 @@ int benchmark(args_params_t const& args) {
 
   std::uint64_t nd = args.nd;  // Number of matrix dimension.
 
-  std::vector<int> inputMatrix = generate_pascal_matrix<int>(nd);
+  matrix_storage<double> inputMatrix = generate_matrix<double>(args);
 
   // Create the solverobject
   solver solve;
   // Measure execution time.
   Timer timer;
   // start decomposation
-  auto res_matrix = solve.Cholesky_Decomposition(inputMatrix, nd);
+  auto lower = solve.Cholesky_Decomposition(inputMatrix, nd);
+  auto time = timer.stop();
+
+  auto res_matrix = matrix_view<double>(lower.data(), nd, nd);
 
   // Print the final results
   if (args.results) {
@@ -110,6 +109,10 @@ int benchmark(args_params_t const& args) {
               << "\n";
   }
 
+  if (args.solve) {
+    report_solve(res_matrix, nd, args.seed);
+  }
+
   return 0;
 }
 
@@ -38,21 +38,21 @@
 #include <numeric>
 #include <vector>
 
+#include "cholesky_solve.hpp"
 #include "matrixutil.hpp"
+#include "packed_layout.hpp"
 
 using namespace std;
 
 struct solver {
 
-  using view_2d = std::extents<int, std::dynamic_extent, std::dynamic_extent>;
-
+  // returns the packed lower triangle of L (see packed_lower_view)
   template <typename T>
-  std::vector<std::vector<T>> Cholesky_Decomposition(std::vector<T>& vec,
-                                                     int n) {
-    std::vector<std::vector<T>> lower(n, std::vector<T>(n, 0));
+  std::vector<T> Cholesky_Decomposition(matrix_storage<T>& vec, int n) {
+    std::vector<T> lower(packed_size(n), 0);
 
-    auto matrix_ms =
-        std::mdspan<T, view_2d, std::layout_right>(vec.data(), n, n);
+    auto matrix_ms = matrix_view<T>(vec.data(), n, n);
+    auto lower_ms = packed_lower_view<T>(lower.data(), n, n);
 
     auto multiplier_lambda = [=](auto a, auto b) {
       return a * b;
@@ -60,24 +60,28 @@ struct solver {
 
     // Decomposing a matrix into Lower Triangular
     for (int i = 0; i < matrix_ms.extent(0); i++) {
+      // rows of the packed factor are contiguous
+      const T* row_i = &lower_ms(i, 0);
+
       for (int j = 0; j <= i; j++) {
+        const T* row_j = &lower_ms(j, 0);
         T sum = 0;
 
         if (j == i)  // summation for diagonals
         {
-          sum = std::transform_reduce(std::execution::par, lower[j].cbegin(),
-                                      lower[j].cbegin() + j, 0, std::plus{},
-                                      [=](int val) { return val * val; });
+          sum = std::transform_reduce(std::execution::par, row_j, row_j + j,
+                                      T(0), std::plus{},
+                                      [=](T val) { return val * val; });
 
-          lower[j][j] = std::sqrt(matrix_ms(i, j) - sum);
+          lower_ms(j, j) = std::sqrt(matrix_ms(i, j) - sum);
 
         } else {  // Evaluating L(i, j) using L(j, j)
 
-          sum = std::transform_reduce(std::execution::par, lower[j].cbegin(),
-                                      lower[j].cbegin() + j, lower[i].cbegin(),
-                                      0, std::plus<>(), multiplier_lambda);
+          sum = std::transform_reduce(std::execution::par, row_j, row_j + j,
+                                      row_i, T(0), std::plus<>(),
+                                      multiplier_lambda);
 
-          lower[i][j] = (matrix_ms(i, j) - sum) / lower[j][j];
+          lower_ms(i, j) = (matrix_ms(i, j) - sum) / lower_ms(j, j);
         }
       }
     }
@@ -90,7 +94,7 @@ int benchmark(args_params_t const& args) {
 
   std::uint64_t nd = args.nd;  // Number of matrix dimension.
 
-  std::vector<int> inputMatrix = generate_pascal_matrix<int>(nd);
+  matrix_storage<double> inputMatrix = generate_matrix<double>(args);
 
   // Create the solver object
   solver solve;
@@ -98,7 +102,10 @@ int benchmark(args_params_t const& args) {
   Timer timer;
 
   // start decomposation
-  auto res_matrix = solve.Cholesky_Decomposition(inputMatrix, nd);
+  auto lower = solve.Cholesky_Decomposition(inputMatrix, nd);
+  auto time = timer.stop();
+
+  auto res_matrix = packed_lower_view<double>(lower.data(), nd, nd);
 
   // Print the final results
   if (args.results) {
@@ -107,12 +114,12 @@ int benchmark(args_params_t const& args) {
     for (int i = 0; i < nd; i++) {
       // Lower Triangular
       for (int j = 0; j < nd; j++)
-        cout << setw(6) << res_matrix[i][j] << "\t";
+        cout << setw(6) << (j <= i ? res_matrix(i, j) : 0) << "\t";
       cout << "\t";
 
       // Transpose of Lower Triangular
       for (int j = 0; j < nd; j++)
-        cout << setw(6) << res_matrix[j][i] << "\t";
+        cout << setw(6) << (i <= j ? res_matrix(j, i) : 0) << "\t";
       cout << endl;
     }
   }
@@ -122,6 +129,10 @@ int benchmark(args_params_t const& args) {
               << "\n";
   }
 
+  if (args.solve) {
+    report_solve(res_matrix, nd, args.seed);
+  }
+
   return 0;
 }
 
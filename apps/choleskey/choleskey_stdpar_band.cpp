@@ -0,0 +1,138 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//
+// This example provides a banded stdpar implementation for choleskey
+// decomposition code for the Laplacian and banded test matrices: only the
+// lower band of half width kd is stored and factored (see cholesky_band.hpp),
+// so nd can reach millions of unknowns where the dense variants cannot
+// allocate the matrix.
+
+#include "argparse/argparse.hpp"
+#include "commons.hpp"
+
+#include <algorithm>
+#include <execution>
+#include <experimental/mdspan>
+#include <iostream>
+#include <vector>
+
+#include "cholesky_band.hpp"
+#include "matrixutil.hpp"
+
+using namespace std;
+
+///////////////////////////////////////////////////////////////////////////////
+int benchmark(args_params_t const& args) {
+
+  band_matrix<double> matrix(args);
+  std::int64_t nd = matrix.n;   // Number of matrix dimension.
+  std::int64_t kd = matrix.kd;  // Half bandwidth.
+  std::int64_t nb = args.nb;    // Columns per block.
+
+  matrix_storage<double> band(nd * (kd + 1));
+  band_view<double> a(band.data(), nd, kd + 1);
+  matrix.fill(a);
+
+  // Measure execution time.
+  Timer timer;
+
+  // start decomposation
+  pbtrf(std::execution::par, a, std::max<std::int64_t>(nb, 1));
+  auto time = timer.stop();
+
+  // Print the final results
+  if (args.results) {
+    // Displaying Lower Triangular and its Transpose
+    cout << setw(6) << " Lower Triangular" << setw(30) << "Transpose" << endl;
+    auto lower = [&](int i, int j) {
+      return j <= i && i - j <= kd ? band_at(a, i, j) : 0.0;
+    };
+    for (int i = 0; i < nd; i++) {
+      // Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << lower(i, j) << "\t";
+      cout << "\t";
+
+      // Transpose of Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << lower(j, i) << "\t";
+      cout << endl;
+    }
+  }
+
+  if (args.time) {
+    // n kd^2 flops
+    double gflops = double(nd) * kd * kd / (time * 1e6);
+    std::cout << "Half bandwidth: " << kd << "\n";
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+    std::cout << "GFLOP/s: " << gflops << "\n";
+  }
+
+  // solve A x = b for a random b and check max |A x - b| / max |b|
+  std::vector<double> b(nd), x(nd);
+  double* pb = b.data();
+  double* px = x.data();
+  std::uint64_t seed = args.seed;
+  for_each_index(std::execution::par, nd,
+                 [=](auto i) { pb[i] = px[i] = uniform<double>(seed, i); });
+  pbtrs(a, px);
+
+  double err = std::transform_reduce(
+      std::execution::par, counting_iterator<std::int64_t>(0),
+      counting_iterator<std::int64_t>(nd), 0.0,
+      [](double u, double v) { return std::max(u, v); },
+      [=](std::int64_t i) {
+        double r = -pb[i];
+        for (std::int64_t j = std::max<std::int64_t>(0, i - kd);
+             j <= std::min<std::int64_t>(nd - 1, i + kd); ++j)
+          r += (j <= i ? matrix(i, j) : matrix(j, i)) * px[j];
+        return std::abs(r);
+      });
+  double scale = std::transform_reduce(
+      std::execution::par, b.begin(), b.end(), 0.0,
+      [](double u, double v) { return std::max(u, v); },
+      [](double v) { return std::abs(v); });
+  std::cout << "Residual: " << err / scale << "\n";
+
+  return 0;
+}
+
+// Driver Code for testing
+int main(int argc, char* argv[]) {
+
+  // parse params
+  args_params_t args = argparse::parse<args_params_t>(argc, argv);
+  // see if help wanted
+  if (args.help) {
+    args.print();  // prints all variables
+    return 0;
+  }
+
+  benchmark(args);
+
+  return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//
+// This example provides a batched stdpar implementation for choleskey
+// decomposition code: nbatch independent nd x nd SPD matrices are factored
+// in one call. The batch is interleaved so that SIMD lanes span matrices
+// (see cholesky_batched.hpp) and the groups of lanes run in parallel. For
+// comparison, the same matrices are factored one per call in row-major
+// storage, in parallel across matrices (the gain of SIMD across matrices at
+// the same thread count) and serially.
+
+#include "argparse/argparse.hpp"
+#include "commons.hpp"
+
+#include <algorithm>
+#include <execution>
+#include <experimental/mdspan>
+#include <iostream>
+#include <vector>
+
+#include "cholesky_batched.hpp"
+#include "cholesky_kernels.hpp"
+#include "matrixutil.hpp"
+
+using namespace std;
+
+// matrix b of the batch: 1 / (1 + |i - j|) off the diagonal, scaled by a
+// random factor in [-1, 1), and n on it, which keeps it strictly diagonally
+// dominant
+template <typename T>
+T batch_entry(std::uint64_t seed, std::int64_t b, std::int64_t n,
+              std::int64_t i, std::int64_t j) {
+  if (i == j)
+    return static_cast<T>(n);
+  std::int64_t r = std::max(i, j), c = std::min(i, j);
+  return uniform<T>(seed, (b * n + r) * n + c) /
+         static_cast<T>(1 + std::abs(i - j));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+int benchmark(args_params_t const& args) {
+
+  std::int64_t nd = args.nd;          // Number of matrix dimension.
+  std::int64_t nbatch = args.nbatch;  // Number of matrices.
+
+  if (nbatch < 1) {
+    std::cerr << "WARNING: nbatch must be at least 1, using 1\n";
+    nbatch = 1;
+  }
+
+  std::int64_t ngroups = batch_groups<double>(nbatch);
+  constexpr int W = batch_lanes<double>;
+
+  // the batch interleaved, and the same matrices one after the other
+  std::vector<double> batch(batch_size<double>(nbatch, nd));
+  std::vector<double> matrices(nbatch * nd * nd);
+  batch_view<double> a(batch.data(), ngroups, nd, nd);
+  double* pm = matrices.data();
+  std::uint64_t seed = args.seed;
+
+  for_each_index(std::execution::par, ngroups * W, [=](auto b) {
+    for (std::int64_t i = 0; i < nd; ++i) {
+      for (std::int64_t j = 0; j < nd; ++j) {
+        // padding lanes of the last group hold the identity
+        double v = b < nbatch ? batch_entry<double>(seed, b, nd, i, j)
+                              : double(i == j);
+        a(b / W, i, j, b % W) = v;
+        if (b < nbatch)
+          pm[(b * nd + i) * nd + j] = v;
+      }
+    }
+  });
+
+  // Measure execution time.
+  Timer timer;
+
+  // start decomposation
+  potrf_batched(std::execution::par, a);
+  auto time = timer.stop();
+
+  // one matrix per call, in parallel across matrices and serially
+  std::vector<double> copy = matrices;
+  double* pc = copy.data();
+  timer.start();
+  for_each_index(std::execution::par, nbatch, [=](auto b) {
+    potrf(make_tile(pc + b * nd * nd, nd, 0, 0, nd, nd));
+  });
+  auto time_par = timer.stop();
+
+  timer.start();
+  for (std::int64_t b = 0; b < nbatch; ++b)
+    potrf(make_tile(matrices.data() + b * nd * nd, nd, 0, 0, nd, nd));
+  auto time_seq = timer.stop();
+
+  // Print the final results of the first matrix
+  if (args.results) {
+    // Displaying Lower Triangular and its Transpose
+    cout << setw(6) << " Lower Triangular" << setw(30) << "Transpose" << endl;
+    auto lower = [&](int i, int j) { return j <= i ? a(0, i, j, 0) : 0.0; };
+    for (int i = 0; i < nd; i++) {
+      // Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << lower(i, j) << "\t";
+      cout << "\t";
+
+      // Transpose of Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << lower(j, i) << "\t";
+      cout << endl;
+    }
+  }
+
+  if (args.time) {
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+    std::cout << "Matrices/s: " << nbatch / (time * 1e-3) << "\n";
+    std::cout << "Parallel per-matrix loop: " << time_par
+              << " ms. (speedup " << time_par / time << ")\n";
+    std::cout << "Serial per-matrix loop: " << time_seq << " ms. (speedup "
+              << time_seq / time << ")\n";
+
+    double diff = 0;
+    for (std::int64_t b = 0; b < nbatch; ++b)
+      for (std::int64_t i = 0; i < nd; ++i)
+        for (std::int64_t j = 0; j <= i; ++j)
+          diff = std::max(diff, std::abs(a(b / W, i, j, b % W) -
+                                         matrices[(b * nd + i) * nd + j]));
+    std::cout << "Max difference: " << diff << "\n";
+  }
+
+  return 0;
+}
+
+// Driver Code for testing
+int main(int argc, char* argv[]) {
+
+  // parse params
+  args_params_t args = argparse::parse<args_params_t>(argc, argv);
+  // see if help wanted
+  if (args.help) {
+    args.print();  // prints all variables
+    return 0;
+  }
+
+  benchmark(args);
+
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//
+// This example provides a column-parallel stdpar implementation for
+// choleskey decomposition code. Column j of L is computed left-looking from
+// columns 0..j-1: the diagonal first, then all n - j - 1 entries below it in
+// one parallel for_each, so there are n synchronization points instead of
+// one per element.
+
+#include "argparse/argparse.hpp"
+#include "commons.hpp"
+
+#include <algorithm>
+#include <execution>
+#include <experimental/mdspan>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "cholesky_solve.hpp"
+#include "matrixutil.hpp"
+#include "packed_layout.hpp"
+
+using namespace std;
+
+struct solver {
+
+  // returns the packed lower triangle of L (see packed_lower_view)
+  template <typename T>
+  std::vector<T> Cholesky_Decomposition(matrix_storage<T>& vec, int n) {
+    std::vector<T> lower(packed_size(n), 0);
+
+    auto matrix_ms = matrix_view<T>(vec.data(), n, n);
+    auto lower_ms = packed_lower_view<T>(lower.data(), n, n);
+
+    for (int j = 0; j < n; j++) {
+      // rows of the packed factor are contiguous
+      T* row_j = &lower_ms(j, 0);
+
+      // L(j, j) from row j of the columns to the left
+      T sum = std::transform_reduce(std::execution::unseq, row_j, row_j + j,
+                                    row_j, T(0));
+      T diag = std::sqrt(matrix_ms(j, j) - sum);
+      row_j[j] = diag;
+
+      // L(i, j) for all i > j only read columns 0..j: one parallel pass
+      for_each_index(std::execution::par, n - j - 1, [=](int r) {
+        int i = j + 1 + r;
+        T* row_i = &lower_ms(i, 0);
+        T s = std::transform_reduce(std::execution::unseq, row_j, row_j + j,
+                                    row_i, T(0));
+        row_i[j] = (matrix_ms(i, j) - s) / diag;
+      });
+    }
+
+    return lower;
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+int benchmark(args_params_t const& args) {
+
+  std::uint64_t nd = args.nd;  // Number of matrix dimension.
+
+  matrix_storage<double> inputMatrix = generate_matrix<double>(args);
+
+  // Create the solver object
+  solver solve;
+  // Measure execution time.
+  Timer timer;
+
+  // start decomposation
+  auto lower = solve.Cholesky_Decomposition(inputMatrix, nd);
+  auto time = timer.stop();
+
+  auto res_matrix = packed_lower_view<double>(lower.data(), nd, nd);
+
+  // Print the final results
+  if (args.results) {
+    // Displaying Lower Triangular and its Transpose
+    cout << setw(6) << " Lower Triangular" << setw(30) << "Transpose" << endl;
+    for (int i = 0; i < nd; i++) {
+      // Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << (j <= i ? res_matrix(i, j) : 0) << "\t";
+      cout << "\t";
+
+      // Transpose of Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << (i <= j ? res_matrix(j, i) : 0) << "\t";
+      cout << endl;
+    }
+  }
+
+  if (args.time) {
+    // n^3 / 3 flops
+    double gflops = double(nd) * nd * nd / 3 / (time * 1e6);
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+    std::cout << "GFLOP/s: " << gflops << "\n";
+  }
+
+  if (args.solve) {
+    report_solve(res_matrix, nd, args.seed);
+  }
+
+  return 0;
+}
+
+// Driver Code for testing
+int main(int argc, char* argv[]) {
+
+  // parse params
+  args_params_t args = argparse::parse<args_params_t>(argc, argv);
+  // see if help wanted
+  if (args.help) {
+    args.print();  // prints all variables
+    return 0;
+  }
+
+  benchmark(args);
+
+  return 0;
+}
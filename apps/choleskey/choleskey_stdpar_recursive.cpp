@@ -0,0 +1,270 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//
+// This example provides a recursive (cache-oblivious) stdpar implementation
+// for choleskey decomposition code. The matrix is split in 2 x 2 blocks:
+// L11 = chol(A11), L21 = A21 L11^-T, A22 -= L21 L21^T, L22 = chol(A22), with
+// recursive TRSM, SYRK and GEMM, so every level of the memory hierarchy sees
+// blocks that fit it without a tuned block size. Independent halves are
+// forked onto a stdexec thread pool, so the recursion and the SIMD leaf
+// kernels stay on the host.
+
+#include "argparse/argparse.hpp"
+#include "commons.hpp"
+
+#include <algorithm>
+#include <exec/async_scope.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <experimental/mdspan>
+#include <iostream>
+#include <stdexec/execution.hpp>
+#include <vector>
+
+#include "cholesky_kernels.hpp"
+#include "cholesky_solve.hpp"
+#include "fork_join.hpp"
+#include "matrixutil.hpp"
+
+using namespace std;
+
+struct solver {
+
+  using view = tile_view<double>;
+  using scheduler =
+      decltype(std::declval<exec::static_thread_pool&>().get_scheduler());
+
+  explicit solver(scheduler sch) : sch(sch) {}
+
+  // forked halves run on sch, tracked by scope
+  scheduler sch;
+  exec::async_scope scope;
+
+  // blocks with all sides at most leaf are done by the loop kernels. this only
+  // bounds the recursion overhead; it is far below any cache size
+  static constexpr int leaf = 64;
+
+  // calls doing fewer flops run their independent halves serially
+  static constexpr double task_flops = 1 << 21;
+
+  // f(0), ..., f(n - 1), concurrently if they do enough work
+  template <typename F>
+  void fork(int n, double flops, F&& f) {
+    if (flops >= task_flops)
+      fork_range(0, n, f);
+    else
+      for (int k = 0; k < n; ++k)
+        f(k);
+  }
+
+  // f(b), ..., f(e - 1) as a binary tree of fork_join
+  template <typename F>
+  void fork_range(int b, int e, F& f) {
+    if (e - b == 1)
+      return f(b);
+
+    int m = (b + e) / 2;
+    fork_join(
+        scope, sch, [&] { fork_range(b, m, f); },
+        [&] { fork_range(m, e, f); });
+  }
+
+  // c = c - a b^T
+  void gemm_rec(view a, view b, view c) {
+    int m = c.extent(0), n = c.extent(1), k = a.extent(1);
+    if (m <= leaf && n <= leaf && k <= leaf)
+      return gemm(a, b, c);
+
+    double flops = 2. * m * n * k;
+    if (m >= n && m >= k) {
+      int h = m / 2;
+      fork(2, flops, [=, this](int s) {
+        int r0 = s ? h : 0, r = s ? m - h : h;
+        gemm_rec(subtile(a, r0, 0, r, k), b, subtile(c, r0, 0, r, n));
+      });
+    } else if (n >= k) {
+      int h = n / 2;
+      fork(2, flops, [=, this](int s) {
+        int c0 = s ? h : 0, cn = s ? n - h : h;
+        gemm_rec(a, subtile(b, c0, 0, cn, k), subtile(c, 0, c0, m, cn));
+      });
+    } else {
+      // split the inner dimension: the two halves update the same c
+      int h = k / 2;
+      gemm_rec(subtile(a, 0, 0, m, h), subtile(b, 0, 0, n, h), c);
+      gemm_rec(subtile(a, 0, h, m, k - h), subtile(b, 0, h, n, k - h), c);
+    }
+  }
+
+  // c = c - a a^T on the lower triangle of c
+  void syrk_rec(view a, view c) {
+    int n = c.extent(0), k = a.extent(1);
+    if (n <= leaf && k <= leaf)
+      return syrk(a, c);
+
+    if (k > n) {
+      // split the inner dimension: the two halves update the same c
+      int h = k / 2;
+      syrk_rec(subtile(a, 0, 0, n, h), c);
+      syrk_rec(subtile(a, 0, h, n, k - h), c);
+      return;
+    }
+
+    int h = n / 2;
+    auto a1 = subtile(a, 0, 0, h, k);
+    auto a2 = subtile(a, h, 0, n - h, k);
+    fork(3, double(n) * n * k, [=, this](int s) {
+      if (s == 0)
+        syrk_rec(a1, subtile(c, 0, 0, h, h));
+      else if (s == 1)
+        gemm_rec(a2, a1, subtile(c, h, 0, n - h, h));
+      else
+        syrk_rec(a2, subtile(c, h, h, n - h, n - h));
+    });
+  }
+
+  // b = b L^-T for the lower triangular l
+  void trsm_rec(view l, view b) {
+    int m = b.extent(0), n = b.extent(1);
+    if (m <= leaf && n <= leaf)
+      return trsm(l, b);
+
+    if (m > n) {
+      // rows of b are independent
+      int h = m / 2;
+      fork(2, double(m) * n * n, [=, this](int s) {
+        int r0 = s ? h : 0, r = s ? m - h : h;
+        trsm_rec(l, subtile(b, r0, 0, r, n));
+      });
+      return;
+    }
+
+    // [b1 b2] [l11 0; l21 l22]^-T: b1 = b1 l11^-T, b2 = (b2 - b1 l21^T) l22^-T
+    int h = n / 2;
+    auto b1 = subtile(b, 0, 0, m, h);
+    auto b2 = subtile(b, 0, h, m, n - h);
+    trsm_rec(subtile(l, 0, 0, h, h), b1);
+    gemm_rec(b1, subtile(l, h, 0, n - h, h), b2);
+    trsm_rec(subtile(l, h, h, n - h, n - h), b2);
+  }
+
+  // a = L L^T in place on the lower triangle
+  void potrf_rec(view a) {
+    int n = a.extent(0);
+    if (n <= leaf)
+      return potrf(a);
+
+    int h = n / 2;
+    auto a11 = subtile(a, 0, 0, h, h);
+    auto a21 = subtile(a, h, 0, n - h, h);
+    auto a22 = subtile(a, h, h, n - h, n - h);
+    potrf_rec(a11);
+    trsm_rec(a11, a21);
+    syrk_rec(a21, a22);
+    potrf_rec(a22);
+  }
+
+  // factor the row-major n x n matrix in place: L overwrites the lower
+  // triangle, the strict upper triangle is left as is
+  template <typename T>
+  void Cholesky_Decomposition(matrix_storage<T>& vec, int n) {
+    potrf_rec(make_tile(vec.data(), n, 0, 0, n, n));
+
+    // spawns whose half was taken back by the forking thread
+    stdexec::sync_wait(scope.on_empty());
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+int benchmark(args_params_t const& args) {
+
+  std::uint64_t nd = args.nd;  // Number of matrix dimension.
+  std::uint64_t np = args.np;  // Number of threads.
+
+  matrix_storage<double> inputMatrix = generate_matrix<double>(args);
+
+  exec::static_thread_pool pool(np);
+
+  // Create the solver object
+  solver solve(pool.get_scheduler());
+  // Measure execution time.
+  Timer timer;
+
+  // start decomposation
+  solve.Cholesky_Decomposition(inputMatrix, nd);
+  auto time = timer.stop();
+
+  // Print the final results
+  if (args.results) {
+    // Displaying Lower Triangular and its Transpose
+    cout << setw(6) << " Lower Triangular" << setw(30) << "Transpose" << endl;
+    auto lower = [&](int i, int j) {
+      return j <= i ? inputMatrix[std::size_t(i) * nd + j] : 0.0;
+    };
+    for (int i = 0; i < nd; i++) {
+      // Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << lower(i, j) << "\t";
+      cout << "\t";
+
+      // Transpose of Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << lower(j, i) << "\t";
+      cout << endl;
+    }
+  }
+
+  if (args.time) {
+    // n^3 / 3 flops
+    double gflops = double(nd) * nd * nd / 3 / (time * 1e6);
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+    std::cout << "GFLOP/s: " << gflops << "\n";
+  }
+
+  if (args.solve) {
+    // L is the lower triangle of the factored matrix
+    report_solve(matrix_view<double>(inputMatrix.data(), nd, nd), nd,
+                 args.seed);
+  }
+
+  return 0;
+}
+
+// Driver Code for testing
+int main(int argc, char* argv[]) {
+
+  // parse params
+  args_params_t args = argparse::parse<args_params_t>(argc, argv);
+  // see if help wanted
+  if (args.help) {
+    args.print();  // prints all variables
+    return 0;
+  }
+
+  benchmark(args);
+
+  return 0;
+}
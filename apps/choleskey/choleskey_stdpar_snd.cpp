@@ -38,35 +38,40 @@
 #include "commons.hpp"
 #include "exec/static_thread_pool.hpp"
 
+#include "cholesky_solve.hpp"
 #include "matrixutil.hpp"
+#include "packed_layout.hpp"
 // using namespace stdexec;
 
 using namespace std;
 
 struct solver {
 
-  using view_2d = std::extents<int, std::dynamic_extent, std::dynamic_extent>;
-
+  // returns the packed lower triangle of L (see packed_lower_view)
   template <typename T>
-  std::vector<std::vector<T>> Cholesky_Decomposition(std::vector<T>& vec, int n,
-                                                     int np) {
+  std::vector<T> Cholesky_Decomposition(matrix_storage<T>& vec, int n, int np) {
 
     // test here first, scheduler from a thread pool
     exec::static_thread_pool pool(np);
     stdexec::scheduler auto sch = pool.get_scheduler();
     stdexec::sender auto begin = stdexec::schedule(sch);
 
-    std::vector<std::vector<T>> lower(n, std::vector<T>(n, 0));
+    std::vector<T> lower(packed_size(n), 0);
 
-    auto matrix_ms =
-        std::mdspan<T, view_2d, std::layout_right>(vec.data(), n, n);
+    auto matrix_ms = matrix_view<T>(vec.data(), n, n);
+    auto lower_ms = packed_lower_view<T>(lower.data(), n, n);
 
     auto multiplier_lambda = [=](auto a, auto b) {
       return a * b;
     };
 
     for (int i = 0; i < matrix_ms.extent(0); i++) {
+      // rows of the packed factor are contiguous
+      T* row_i = &lower_ms(i, 0);
+
       for (int j = 0; j <= i; j++) {
+        T* row_j = &lower_ms(j, 0);
+
         // avoid over parallelize
         if (j == 0) {
           np = 1;
@@ -78,7 +83,7 @@ struct solver {
         {
 
           if (i == 0 && j == 0) {
-            lower[j][j] = std::sqrt(matrix_ms(i, j));
+            lower_ms(j, j) = std::sqrt(matrix_ms(i, j));
           } else {
 
             std::vector<T> sum_vec(np);  // sub res for each piece
@@ -95,9 +100,9 @@ struct solver {
                                 sum_vec[piece] = std::transform_reduce(
                                     std::execution::par,
                                     counting_iterator(start),
-                                    counting_iterator(start + chunk_size), 0,
+                                    counting_iterator(start + chunk_size), T(0),
                                     std ::plus{}, [=](int val) {
-                                      return lower[j][val] * lower[j][val];
+                                      return row_j[val] * row_j[val];
                                     });
                               }) |
                 stdexec::then([&sum_vec]() {
@@ -107,14 +112,14 @@ struct solver {
 
             auto [sum1] = stdexec::sync_wait(std::move(send1)).value();
 
-            lower[j][j] = std::sqrt(matrix_ms(i, j) - sum1);
+            lower_ms(j, j) = std::sqrt(matrix_ms(i, j) - sum1);
           }
 
         } else {
           // Evaluating L(i, j) using L(j, j)
 
           if (j == 0) {
-            lower[i][j] = (matrix_ms(i, j)) / lower[j][j];
+            lower_ms(i, j) = (matrix_ms(i, j)) / lower_ms(j, j);
           } else {
 
             std::vector<T> sum_vec(np);  // sub res for each piece
@@ -131,9 +136,9 @@ struct solver {
 
                       sum_vec[piece] = std::transform_reduce(
                           std::execution::par, counting_iterator(start),
-                          counting_iterator(start + chunk_size), 0,
+                          counting_iterator(start + chunk_size), T(0),
                           std ::plus{},
-                          [=](int k) { return lower[j][k] * lower[i][k]; });
+                          [=](int k) { return row_j[k] * row_i[k]; });
                     }) |
                 stdexec::then([&sum_vec]() {
                   return std::reduce(std::execution::par, sum_vec.begin(),
@@ -142,7 +147,7 @@ struct solver {
 
             auto [sum2] = stdexec::sync_wait(std::move(send2)).value();
 
-            lower[i][j] = (matrix_ms(i, j) - sum2) / lower[j][j];
+            lower_ms(i, j) = (matrix_ms(i, j) - sum2) / lower_ms(j, j);
           }
         }
       }
@@ -157,7 +162,7 @@ int benchmark(args_params_t const& args) {
   std::uint64_t nd = args.nd;  // Number of matrix dimension.
   std::uint64_t np = args.np;  // Number of parallel partitions.
 
-  std::vector<int> inputMatrix = generate_pascal_matrix<int>(nd);
+  matrix_storage<double> inputMatrix = generate_matrix<double>(args);
 
   // Create the solver object
   solver solve;
@@ -166,7 +171,10 @@ int benchmark(args_params_t const& args) {
   Timer timer;
 
   // start decomposation
-  auto res_matrix = solve.Cholesky_Decomposition(inputMatrix, nd, np);
+  auto lower = solve.Cholesky_Decomposition(inputMatrix, nd, np);
+  auto time = timer.stop();
+
+  auto res_matrix = packed_lower_view<double>(lower.data(), nd, nd);
 
   // Print the final results
   if (args.results) {
@@ -175,12 +183,12 @@ int benchmark(args_params_t const& args) {
     for (int i = 0; i < nd; i++) {
       // Lower Triangular
       for (int j = 0; j < nd; j++)
-        cout << setw(6) << res_matrix[i][j] << "\t";
+        cout << setw(6) << (j <= i ? res_matrix(i, j) : 0) << "\t";
       cout << "\t";
 
       // Transpose of Lower Triangular
       for (int j = 0; j < nd; j++)
-        cout << setw(6) << res_matrix[j][i] << "\t";
+        cout << setw(6) << (i <= j ? res_matrix(j, i) : 0) << "\t";
       cout << endl;
     }
   }
@@ -190,6 +198,10 @@ int benchmark(args_params_t const& args) {
               << "\n";
   }
 
+  if (args.solve) {
+    report_solve(res_matrix, nd, args.seed);
+  }
+
   return 0;
 }
 
@@ -0,0 +1,234 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+//
+// This example provides a tiled stdexec(senders/receivers) implementation for
+// choleskey decomposition code. The matrix is split into nb x nb tiles and
+// every tile kernel (POTRF, TRSM, SYRK, GEMM) is a task on the thread pool
+// that starts as soon as the tiles it reads are final, so independent tiles
+// of different steps run concurrently.
+
+#include <algorithm>
+#include <atomic>
+#include <exec/async_scope.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <experimental/mdspan>
+#include <iostream>
+#include <memory>
+#include <stdexec/execution.hpp>
+#include <vector>
+#include "argparse/argparse.hpp"
+#include "commons.hpp"
+
+#include "cholesky_kernels.hpp"
+#include "cholesky_solve.hpp"
+#include "matrixutil.hpp"
+
+using namespace std;
+
+struct solver {
+
+  // op (i, j, m) of tile (i, j), m <= j <= i: for m < j the update with
+  // column m (SYRK if i == j, GEMM otherwise), for m == j the final POTRF
+  // (i == j) or TRSM. ops of a tile run in order of m
+  int n = 0;
+  int nb = 0;
+  int nt = 0;
+  double* a = nullptr;
+
+  // first op of tile (i, j) in deps
+  std::vector<std::size_t> first_op;
+
+  // inputs op (i, j, m) still waits for
+  std::unique_ptr<std::atomic<int>[]> deps;
+
+  // tasks in flight
+  exec::async_scope scope;
+
+  tile_view<double> tile(int i, int j) {
+    int rows = std::min(nb, n - i * nb);
+    int cols = std::min(nb, n - j * nb);
+    return make_tile(a, n, i * nb, j * nb, rows, cols);
+  }
+
+  std::atomic<int>& dep(int i, int j, int m) {
+    return deps[first_op[i * nt + j] + m];
+  }
+
+  // the previous op of the tile, plus the final tiles (i, m) and (j, m) for
+  // an update or (j, j) for a TRSM
+  static int inputs(int i, int j, int m) {
+    int prev = m > 0 ? 1 : 0;
+    if (m < j)
+      return prev + (i == j ? 1 : 2);
+    return prev + (i == j ? 0 : 1);
+  }
+
+  void run(auto sch, int i, int j, int m) {
+    auto c = tile(i, j);
+
+    if (m < j) {
+      if (i == j)
+        syrk(tile(i, m), c);
+      else
+        gemm(tile(i, m), tile(j, m), c);
+      release(sch, i, j, m + 1);
+      return;
+    }
+
+    if (i == j) {
+      potrf(c);
+      for (int r = j + 1; r < nt; ++r)
+        release(sch, r, j, j);
+      return;
+    }
+
+    // L(i, j) is final: it feeds the step j updates of row i and column i
+    trsm(tile(j, j), c);
+    for (int s = j + 1; s <= i; ++s)
+      release(sch, i, s, j);
+    for (int r = i + 1; r < nt; ++r)
+      release(sch, r, i, j);
+  }
+
+  // one input of op (i, j, m) is ready. the last one spawns it
+  void release(auto sch, int i, int j, int m) {
+    if (dep(i, j, m).fetch_sub(1, std::memory_order_acq_rel) == 1)
+      spawn(sch, i, j, m);
+  }
+
+  void spawn(auto sch, int i, int j, int m) {
+    scope.spawn(stdexec::schedule(sch) |
+                stdexec::then([=, this] { run(sch, i, j, m); }));
+  }
+
+  // factor the row-major n x n matrix in place: L overwrites the lower
+  // triangle, the strict upper triangle is left as is
+  template <typename T>
+  void Cholesky_Decomposition(auto sch, matrix_storage<T>& vec, int n, int nb) {
+    this->n = n;
+    this->nb = nb;
+    this->nt = (n + nb - 1) / nb;
+    this->a = vec.data();
+
+    first_op.assign(nt * nt, 0);
+    std::size_t nops = 0;
+    for (int i = 0; i < nt; ++i)
+      for (int j = 0; j <= i; ++j) {
+        first_op[i * nt + j] = nops;
+        nops += j + 1;
+      }
+
+    deps = std::make_unique<std::atomic<int>[]>(nops);
+    for (int i = 0; i < nt; ++i)
+      for (int j = 0; j <= i; ++j)
+        for (int m = 0; m <= j; ++m)
+          dep(i, j, m).store(inputs(i, j, m), std::memory_order_relaxed);
+
+    if (nt == 0)
+      return;
+
+    // POTRF of the first diagonal tile is the only op without inputs
+    spawn(sch, 0, 0, 0);
+
+    stdexec::sync_wait(scope.on_empty());
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+int benchmark(args_params_t const& args) {
+
+  std::uint64_t nd = args.nd;  // Number of matrix dimension.
+  std::uint64_t np = args.np;  // Number of threads.
+  std::uint64_t nb = args.nb;  // Tile size.
+
+  matrix_storage<double> inputMatrix = generate_matrix<double>(args);
+
+  // Create the solver object
+  solver solve;
+
+  exec::static_thread_pool pool(np);
+  stdexec::scheduler auto sch = pool.get_scheduler();
+
+  // Measure execution time.
+  Timer timer;
+
+  // start decomposation
+  solve.Cholesky_Decomposition(sch, inputMatrix, nd, std::max<int>(nb, 1));
+
+  auto time = timer.stop();
+
+  // Print the final results
+  if (args.results) {
+    // Displaying Lower Triangular and its Transpose
+    cout << setw(6) << " Lower Triangular" << setw(30) << "Transpose" << endl;
+    auto lower = [&](int i, int j) {
+      return j <= i ? inputMatrix[std::size_t(i) * nd + j] : 0.0;
+    };
+    for (int i = 0; i < nd; i++) {
+      // Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << lower(i, j) << "\t";
+      cout << "\t";
+
+      // Transpose of Lower Triangular
+      for (int j = 0; j < nd; j++)
+        cout << setw(6) << lower(j, i) << "\t";
+      cout << endl;
+    }
+  }
+
+  if (args.time) {
+    // n^3 / 3 flops
+    double gflops = double(nd) * nd * nd / 3 / (time * 1e6);
+    std::cout << "Duration: " << time << " ms."
+              << "\n";
+    std::cout << "GFLOP/s: " << gflops << "\n";
+  }
+
+  if (args.solve) {
+    // L is the lower triangle of the factored matrix
+    report_solve(matrix_view<double>(inputMatrix.data(), nd, nd), nd,
+                 args.seed);
+  }
+
+  return 0;
+}
+
+// Driver Code for testing
+int main(int argc, char* argv[]) {
+
+  // parse params
+  args_params_t args = argparse::parse<args_params_t>(argc, argv);
+  // see if help wanted
+  if (args.help) {
+    args.print();  // prints all variables
+    return 0;
+  }
+
+  benchmark(args);
+
+  return 0;
+}
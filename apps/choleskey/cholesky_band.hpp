@@ -0,0 +1,187 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// Cholesky factorization of symmetric positive definite band matrices with
+// half bandwidth kd. L has the band of A, so only the lower band is stored:
+// row i of an (n, kd + 1) row-major array holds A(i, i - kd .. i), i.e.
+// A(i, j) sits at (i, j - i + kd). storage and work are O(n kd) and
+// O(n kd^2) instead of O(n^2) and O(n^3).
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <experimental/mdspan>
+#include <iostream>
+#include <vector>
+
+#include "commons.hpp"
+#include "matrixutil.hpp"
+
+template <typename T>
+using band_view =
+    std::mdspan<T,
+                std::extents<std::int64_t, std::dynamic_extent,
+                             std::dynamic_extent>,
+                std::layout_right>;
+
+// A(i, j), j in [i - kd, i], of the band matrix a
+template <typename T>
+T& band_at(band_view<T> a, std::int64_t i, std::int64_t j) {
+  return a(i, j - i + a.extent(1) - 1);
+}
+
+// the band matrices of --matrix in band storage: laplace1d (kd = 1),
+// laplace2d (kd = grid width ceil(sqrt(n)), the default) and banded
+// (kd = bw), with the same entries as the dense generators in matrixutil.hpp
+template <typename T>
+struct band_matrix {
+  enum kind_t { laplace1d, laplace2d, banded };
+
+  kind_t kind = laplace2d;
+  std::int64_t n;
+  std::int64_t kd;
+  std::int64_t m;   // grid width of laplace2d
+  std::int64_t bw;  // half bandwidth of banded
+  std::uint64_t seed;
+
+  band_matrix(args_params_t const& args)
+      : n(args.nd), bw(args.bw), seed(args.seed) {
+    if (args.matrix == "laplace1d")
+      kind = laplace1d;
+    else if (args.matrix == "banded")
+      kind = banded;
+    else if (args.matrix != "laplace2d" && !args.matrix.empty())
+      std::cerr << "WARNING: " << args.matrix
+                << " is not a band matrix, using laplace2d\n";
+
+    m = std::ceil(std::sqrt(static_cast<double>(n)));
+    kd = kind == laplace1d ? 1 : kind == laplace2d ? m : bw;
+    kd = std::min<std::int64_t>(kd, std::max<std::int64_t>(n - 1, 0));
+  }
+
+  // A(i, j) for j in [i - kd, i]
+  T operator()(std::int64_t i, std::int64_t j) const {
+    switch (kind) {
+      case laplace1d:
+        return i == j ? T(2) : T(-1);
+      case laplace2d:
+        if (i == j)
+          return T(4);
+        return (i - j == 1 && i % m != 0) || i - j == m ? T(-1) : T(0);
+      default:
+        if (i == j)
+          return static_cast<T>(2 * bw + 1);
+        return uniform<T>(seed, i * (bw + 1) + (i - j));
+    }
+  }
+
+  void fill(band_view<T> a) const {
+    for_each_index(std::execution::par, n, [=, *this](auto i) {
+      for (std::int64_t j = std::max<std::int64_t>(0, i - kd); j <= i; ++j)
+        band_at(a, i, j) = (*this)(i, j);
+    });
+  }
+};
+
+// a = L L^T in place (PBTRF), right-looking in blocks of nb columns. per
+// block: factor the diagonal block, compute the rows of L below it in
+// parallel, then update the trailing band in parallel, one row per index
+template <typename ExecutionPolicy, typename T>
+void pbtrf(ExecutionPolicy&& policy, band_view<T> a, std::int64_t nb) {
+  std::int64_t n = a.extent(0);
+  std::int64_t kd = a.extent(1) - 1;
+
+  for (std::int64_t j0 = 0; j0 < n; j0 += nb) {
+    std::int64_t j1 = std::min(n, j0 + nb);
+
+    // diagonal block; columns left of j0 were applied by earlier blocks
+    for (std::int64_t j = j0; j < j1; ++j) {
+      std::int64_t lo = std::max(j0, j - kd);
+      T d = band_at(a, j, j);
+      for (std::int64_t p = lo; p < j; ++p)
+        d -= band_at(a, j, p) * band_at(a, j, p);
+      d = std::sqrt(d);
+      band_at(a, j, j) = d;
+
+      for (std::int64_t i = j + 1; i < std::min(j1, j + kd + 1); ++i) {
+        T s = band_at(a, i, j);
+        for (std::int64_t p = std::max(lo, i - kd); p < j; ++p)
+          s -= band_at(a, i, p) * band_at(a, j, p);
+        band_at(a, i, j) = s / d;
+      }
+    }
+
+    // rows below the block that reach into it
+    std::int64_t i1 = std::min(n, j1 + kd);
+    for_each_index(policy, i1 - j1, [=](auto r) {
+      std::int64_t i = j1 + r;
+      for (std::int64_t j = std::max(j0, i - kd); j < j1; ++j) {
+        T s = band_at(a, i, j);
+        for (std::int64_t p = std::max({j0, i - kd, j - kd}); p < j; ++p)
+          s -= band_at(a, i, p) * band_at(a, j, p);
+        band_at(a, i, j) = s / band_at(a, j, j);
+      }
+    });
+
+    // A(i, c) -= L(i, j0:j1) L(c, j0:j1) for j1 <= c <= i
+    for_each_index(policy, i1 - j1, [=](auto r) {
+      std::int64_t i = j1 + r;
+      for (std::int64_t c = std::max(j1, i - kd); c <= i; ++c) {
+        T s = 0;
+        for (std::int64_t p = std::max({j0, i - kd, c - kd}); p < j1; ++p)
+          s += band_at(a, i, p) * band_at(a, c, p);
+        band_at(a, i, c) -= s;
+      }
+    });
+  }
+}
+
+// solve A x = b in place given the band factor L
+template <typename T>
+void pbtrs(band_view<T> l, T* b) {
+  std::int64_t n = l.extent(0);
+  std::int64_t kd = l.extent(1) - 1;
+
+  // L y = b
+  for (std::int64_t i = 0; i < n; ++i) {
+    T s = b[i];
+    for (std::int64_t j = std::max<std::int64_t>(0, i - kd); j < i; ++j)
+      s -= band_at(l, i, j) * b[j];
+    b[i] = s / band_at(l, i, i);
+  }
+
+  // L^T x = y, pushing each solved row into the rows above it
+  for (std::int64_t i = n - 1; i >= 0; --i) {
+    b[i] /= band_at(l, i, i);
+    for (std::int64_t j = std::max<std::int64_t>(0, i - kd); j < i; ++j)
+      b[j] -= band_at(l, i, j) * b[i];
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// batched Cholesky factorization of many small same-size SPD matrices. the
+// batch is interleaved in groups of one SIMD vector: element (i, j) of the
+// matrices of a group sits in consecutive lanes, so every SIMD operation of
+// the factorization works on simd_t<T>::size() matrices at once, and the
+// groups are spread across threads
+//
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <experimental/mdspan>
+
+#include "cholesky_kernels.hpp"
+#include "commons.hpp"
+
+// matrices per group
+template <typename T>
+constexpr int batch_lanes = simd_t<T>::size();
+
+// (group, i, j, lane); matrix b is group b / batch_lanes, lane b % batch_lanes
+template <typename T>
+using batch_extents = std::extents<std::int64_t, std::dynamic_extent,
+                                   std::dynamic_extent, std::dynamic_extent,
+                                   batch_lanes<T>>;
+
+template <typename T>
+using batch_view = std::mdspan<T, batch_extents<T>, std::layout_right>;
+
+// groups needed for nbatch matrices; lanes of the last group past nbatch are
+// padding and should hold an SPD matrix (e.g. the identity)
+template <typename T>
+std::int64_t batch_groups(std::int64_t nbatch) {
+  return (nbatch + batch_lanes<T> - 1) / batch_lanes<T>;
+}
+
+template <typename T>
+std::int64_t batch_size(std::int64_t nbatch, std::int64_t n) {
+  return batch_groups<T>(nbatch) * n * n * batch_lanes<T>;
+}
+
+// a = L L^T in place on the lower triangles of the n x n matrices of one
+// group, stored at a with element (i, j) at a + (i * n + j) * lanes
+template <typename T>
+void potrf_group(T* a, int n) {
+  using V = simd_t<T>;
+  constexpr int W = V::size();
+  auto at = [=](int i, int j) { return a + (std::size_t(i) * n + j) * W; };
+
+  for (int j = 0; j < n; ++j) {
+    V d = simd_load(at(j, j));
+    for (int p = 0; p < j; ++p) {
+      V ljp = simd_load(at(j, p));
+      d = d - ljp * ljp;
+    }
+    d = sqrt(d);
+    simd_store(d, at(j, j));
+    V inv = V(T(1)) / d;
+
+    for (int i = j + 1; i < n; ++i) {
+      V s = simd_load(at(i, j));
+      for (int p = 0; p < j; ++p)
+        s = s - simd_load(at(i, p)) * simd_load(at(j, p));
+      simd_store(s * inv, at(i, j));
+    }
+  }
+}
+
+// factor every matrix of the batch in place
+template <typename ExecutionPolicy, typename T>
+void potrf_batched(ExecutionPolicy&& policy, batch_view<T> a) {
+  int n = a.extent(1);
+  for_each_index(policy, a.extent(0),
+                 [=](auto g) { potrf_group(&a(g, 0, 0, 0), n); });
+}
@@ -0,0 +1,236 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// tile kernels of the blocked Cholesky factorization A = L L^T. a tile is a
+// strided view into the row-major matrix; only lower triangles are touched
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <experimental/mdspan>
+#include <vector>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+
+// native SIMD vector of T
+template <typename T>
+using simd_t = std::experimental::native_simd<T>;
+
+template <typename T>
+simd_t<T> simd_load(const T* p) {
+  return simd_t<T>(p, std::experimental::element_aligned);
+}
+
+template <typename T>
+void simd_store(simd_t<T> const& v, T* p) {
+  v.copy_to(p, std::experimental::element_aligned);
+}
+#else
+// one-lane stand-in where <experimental/simd> is not available
+template <typename T>
+struct simd_t {
+  T v = 0;
+
+  simd_t() = default;
+  simd_t(T x) : v(x) {}
+
+  static constexpr int size() { return 1; }
+
+  simd_t& operator+=(simd_t const& o) {
+    v += o.v;
+    return *this;
+  }
+
+  friend simd_t operator-(simd_t const& a, simd_t const& b) {
+    return a.v - b.v;
+  }
+
+  friend simd_t operator*(simd_t const& a, simd_t const& b) {
+    return a.v * b.v;
+  }
+
+  friend simd_t operator/(simd_t const& a, simd_t const& b) {
+    return a.v / b.v;
+  }
+
+  friend simd_t sqrt(simd_t const& a) { return std::sqrt(a.v); }
+};
+
+template <typename T>
+simd_t<T> simd_load(const T* p) {
+  return *p;
+}
+
+template <typename T>
+void simd_store(simd_t<T> const& v, T* p) {
+  *p = v.v;
+}
+#endif
+
+// 64-bit indices: the top-level tile of the recursive variant is the whole
+// matrix, and i * n overflows int past n = 46340
+using tile_extents =
+    std::extents<std::int64_t, std::dynamic_extent, std::dynamic_extent>;
+
+template <typename T>
+using tile_view = std::mdspan<T, tile_extents, std::layout_stride>;
+
+// rows x cols view of the row-major n x n matrix a at (i0, j0)
+template <typename T>
+tile_view<T> make_tile(T* a, std::int64_t n, std::int64_t i0, std::int64_t j0,
+                       std::int64_t rows, std::int64_t cols) {
+  std::array<std::int64_t, 2> strides = {n, 1};
+  return tile_view<T>(a + i0 * n + j0,
+                      std::layout_stride::mapping<tile_extents>(
+                          tile_extents(rows, cols), strides));
+}
+
+// rows x cols view of the tile a at (i0, j0)
+template <typename T>
+tile_view<T> subtile(tile_view<T> a, std::int64_t i0, std::int64_t j0,
+                     std::int64_t rows, std::int64_t cols) {
+  std::array<std::int64_t, 2> strides = {a.stride(0), a.stride(1)};
+  return tile_view<T>(a.data_handle() + i0 * strides[0] + j0 * strides[1],
+                      std::layout_stride::mapping<tile_extents>(
+                          tile_extents(rows, cols), strides));
+}
+
+// a = L L^T in place on the lower triangle (POTRF)
+template <typename T>
+void potrf(tile_view<T> a) {
+  int n = a.extent(0);
+  for (int j = 0; j < n; ++j) {
+    T d = a(j, j);
+    for (int p = 0; p < j; ++p)
+      d -= a(j, p) * a(j, p);
+    d = std::sqrt(d);
+    a(j, j) = d;
+
+    for (int i = j + 1; i < n; ++i) {
+      T s = a(i, j);
+      for (int p = 0; p < j; ++p)
+        s -= a(i, p) * a(j, p);
+      a(i, j) = s / d;
+    }
+  }
+}
+
+// b = b L^-T for the lower triangular l (TRSM)
+template <typename T>
+void trsm(tile_view<T> l, tile_view<T> b) {
+  for (int r = 0; r < b.extent(0); ++r) {
+    for (int c = 0; c < b.extent(1); ++c) {
+      T s = b(r, c);
+      for (int p = 0; p < c; ++p)
+        s -= b(r, p) * l(c, p);
+      b(r, c) = s / l(c, c);
+    }
+  }
+}
+
+// c = c - a b^T (lower = false) or its lower triangle (lower = true) with
+// register blocking: a and b are packed into MR-row and NR-row slivers
+// (k-major, zero padded) and every MR x NR block of c is accumulated in
+// vector registers, so each loaded element of a and b is reused NR or MR
+// times
+template <typename T>
+void update_blocked(tile_view<T> a, tile_view<T> b, tile_view<T> c,
+                    bool lower) {
+  constexpr int W = simd_t<T>::size();
+  constexpr int MR = 4;
+  constexpr int NR = 2 * W;
+
+  int m = c.extent(0), n = c.extent(1), k = a.extent(1);
+  int mb = (m + MR - 1) / MR, nbk = (n + NR - 1) / NR;
+
+  // packed panels, reused across calls on the same thread
+  thread_local std::vector<T> ap, bp;
+  ap.assign(std::size_t(mb) * MR * k, T(0));
+  bp.assign(std::size_t(nbk) * NR * k, T(0));
+
+  for (int r = 0; r < m; ++r)
+    for (int p = 0; p < k; ++p)
+      ap[(std::size_t(r / MR) * k + p) * MR + r % MR] = a(r, p);
+  for (int s = 0; s < n; ++s)
+    for (int p = 0; p < k; ++p)
+      bp[(std::size_t(s / NR) * k + p) * NR + s % NR] = b(s, p);
+
+  for (int ib = 0; ib < mb; ++ib) {
+    for (int jb = 0; jb < nbk; ++jb) {
+      // blocks strictly above the diagonal do not touch the lower triangle
+      if (lower && jb * NR > ib * MR + MR - 1)
+        break;
+
+      const T* pa = &ap[std::size_t(ib) * k * MR];
+      const T* pb = &bp[std::size_t(jb) * k * NR];
+
+      // micro-kernel: MR x NR outputs in 2 * MR vector registers
+      simd_t<T> acc[MR][2] = {};
+      for (int p = 0; p < k; ++p) {
+        simd_t<T> b0 = simd_load(pb + p * NR);
+        simd_t<T> b1 = simd_load(pb + p * NR + W);
+        for (int r = 0; r < MR; ++r) {
+          simd_t<T> ar(pa[p * MR + r]);
+          acc[r][0] += ar * b0;
+          acc[r][1] += ar * b1;
+        }
+      }
+
+      T out[MR][NR];
+      for (int r = 0; r < MR; ++r) {
+        simd_store(acc[r][0], out[r]);
+        simd_store(acc[r][1], out[r] + W);
+      }
+
+      int r1 = std::min(MR, m - ib * MR);
+      int s1 = std::min(NR, n - jb * NR);
+      for (int r = 0; r < r1; ++r) {
+        int i = ib * MR + r;
+        int send = lower ? std::min(s1, i - jb * NR + 1) : s1;
+        for (int s = 0; s < send; ++s)
+          c(i, jb * NR + s) -= out[r][s];
+      }
+    }
+  }
+}
+
+// c = c - a a^T on the lower triangle of c (SYRK)
+template <typename T>
+void syrk(tile_view<T> a, tile_view<T> c) {
+  update_blocked(a, a, c, true);
+}
+
+// c = c - a b^T (GEMM)
+template <typename T>
+void gemm(tile_view<T> a, tile_view<T> b, tile_view<T> c) {
+  update_blocked(a, b, c, false);
+}
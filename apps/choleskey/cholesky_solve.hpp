@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// triangular solves with a Cholesky factor L for an n x k block of right-hand
+// sides: A X = B is L Y = B (forward) followed by L^T X = Y (back). B is
+// row-major and is overwritten with the solution. The k columns are cut into
+// blocks of solve_kb that are solved in parallel; within a block, L is walked
+// in nb x nb tiles so a tile of B stays in cache while it is updated.
+//
+// L is any 2D view whose rows are contiguous and valid for j <= i, i.e. the
+// row-major factor (upper triangle ignored) or the packed lower triangle.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <iostream>
+#include <vector>
+
+#include "commons.hpp"
+#include "matrixutil.hpp"
+
+// right-hand side columns per parallel block
+constexpr std::int64_t solve_kb = 32;
+// rows of L per tile
+constexpr std::int64_t solve_nb = 128;
+
+// b[i0, i1) -= L[i0, i1) x [j0, j1) * b[j0, j1) on columns [c0, c1)
+template <typename LView, typename T>
+void solve_update(LView l, matrix_view<T> b, std::int64_t i0, std::int64_t i1,
+                  std::int64_t j0, std::int64_t j1, std::int64_t c0,
+                  std::int64_t c1) {
+  for (std::int64_t i = i0; i < i1; ++i) {
+    const T* li = &l(i, 0);
+    T* bi = &b(i, 0);
+    for (std::int64_t j = j0; j < j1; ++j) {
+      const T* bj = &b(j, 0);
+      T lij = li[j];
+      for (std::int64_t c = c0; c < c1; ++c)
+        bi[c] -= lij * bj[c];
+    }
+  }
+}
+
+// b[j0, j1) -= L[i0, i1) x [j0, j1)^T * b[i0, i1) on columns [c0, c1)
+template <typename LView, typename T>
+void solve_update_transposed(LView l, matrix_view<T> b, std::int64_t i0,
+                             std::int64_t i1, std::int64_t j0, std::int64_t j1,
+                             std::int64_t c0, std::int64_t c1) {
+  for (std::int64_t i = i0; i < i1; ++i) {
+    const T* li = &l(i, 0);
+    const T* bi = &b(i, 0);
+    for (std::int64_t j = j0; j < j1; ++j) {
+      T* bj = &b(j, 0);
+      T lij = li[j];
+      for (std::int64_t c = c0; c < c1; ++c)
+        bj[c] -= lij * bi[c];
+    }
+  }
+}
+
+// solve L Y = B in place
+template <typename ExecutionPolicy, typename LView, typename T>
+void forward_substitution(ExecutionPolicy&& policy, LView l,
+                          matrix_view<T> b) {
+  std::int64_t n = b.extent(0);
+  std::int64_t k = b.extent(1);
+  std::int64_t nblocks = (k + solve_kb - 1) / solve_kb;
+
+  for_each_index(policy, nblocks, [=](auto blk) {
+    std::int64_t c0 = blk * solve_kb;
+    std::int64_t c1 = std::min(k, c0 + solve_kb);
+
+    for (std::int64_t i0 = 0; i0 < n; i0 += solve_nb) {
+      std::int64_t i1 = std::min(n, i0 + solve_nb);
+
+      // contributions of the rows already solved
+      for (std::int64_t j0 = 0; j0 < i0; j0 += solve_nb)
+        solve_update(l, b, i0, i1, j0, std::min(i0, j0 + solve_nb), c0, c1);
+
+      // diagonal tile
+      for (std::int64_t i = i0; i < i1; ++i) {
+        solve_update(l, b, i, i + 1, i0, i, c0, c1);
+        T* bi = &b(i, 0);
+        T inv = T(1) / l(i, i);
+        for (std::int64_t c = c0; c < c1; ++c)
+          bi[c] *= inv;
+      }
+    }
+  });
+}
+
+// solve L^T X = Y in place. rows are solved last to first and each solved
+// row is pushed into the rows above it, so L is still read along its rows.
+template <typename ExecutionPolicy, typename LView, typename T>
+void back_substitution(ExecutionPolicy&& policy, LView l, matrix_view<T> b) {
+  std::int64_t n = b.extent(0);
+  std::int64_t k = b.extent(1);
+  std::int64_t nblocks = (k + solve_kb - 1) / solve_kb;
+
+  for_each_index(policy, nblocks, [=](auto blk) {
+    std::int64_t c0 = blk * solve_kb;
+    std::int64_t c1 = std::min(k, c0 + solve_kb);
+    std::int64_t ntiles = (n + solve_nb - 1) / solve_nb;
+
+    for (std::int64_t t = ntiles - 1; t >= 0; --t) {
+      std::int64_t i0 = t * solve_nb;
+      std::int64_t i1 = std::min(n, i0 + solve_nb);
+
+      // diagonal tile
+      for (std::int64_t i = i1 - 1; i >= i0; --i) {
+        T* bi = &b(i, 0);
+        T inv = T(1) / l(i, i);
+        for (std::int64_t c = c0; c < c1; ++c)
+          bi[c] *= inv;
+        solve_update_transposed(l, b, i, i + 1, i0, i, c0, c1);
+      }
+
+      // push the solved tile into the rows above it
+      for (std::int64_t j0 = 0; j0 < i0; j0 += solve_nb)
+        solve_update_transposed(l, b, i0, i1, j0,
+                                std::min(i0, j0 + solve_nb), c0, c1);
+    }
+  });
+}
+
+// solve A X = B in place given the Cholesky factor L of A
+template <typename ExecutionPolicy, typename LView, typename T>
+void cholesky_solve(ExecutionPolicy&& policy, LView l, matrix_view<T> b) {
+  forward_substitution(policy, l, b);
+  back_substitution(policy, l, b);
+}
+
+// time cholesky_solve for k = 1, 2, 4, ..., 1024 random right-hand sides and
+// print the throughput (2 n^2 k flops) and the relative residual of the first
+// column, max |L L^T x - b| / max |b|
+template <typename LView>
+void report_solve(LView l, std::int64_t n, std::uint64_t seed = 0) {
+  using T = std::remove_cvref_t<decltype(l(0, 0))>;
+
+  for (std::int64_t k = 1; k <= 1024; k *= 2) {
+    std::vector<T> rhs(n * k);
+    for_each_index(std::execution::par, n * k,
+                   [=, p = rhs.data()](auto i) { p[i] = uniform<T>(seed, i); });
+    std::vector<T> x = rhs;
+
+    Timer timer;
+    cholesky_solve(std::execution::par, l, matrix_view<T>(x.data(), n, k));
+    auto time = timer.stop();
+
+    // y = L^T x(:, 0), then r = L y - b(:, 0)
+    std::vector<T> y(n);
+    for (std::int64_t j = 0; j < n; ++j) {
+      const T* lj = &l(j, 0);
+      for (std::int64_t i = 0; i <= j; ++i)
+        y[i] += lj[i] * x[j * k];
+    }
+    T err = 0, scale = 0;
+    for (std::int64_t i = 0; i < n; ++i) {
+      const T* li = &l(i, 0);
+      T r = -rhs[i * k];
+      for (std::int64_t j = 0; j <= i; ++j)
+        r += li[j] * y[j];
+      err = std::max(err, std::abs(r));
+      scale = std::max(scale, std::abs(rhs[i * k]));
+    }
+
+    double gflops = 2.0 * n * n * k / (time * 1e6);
+    std::cout << "Solve k=" << k << ": " << time << " ms, " << gflops
+              << " GFLOP/s, residual " << err / scale << "\n";
+  }
+}
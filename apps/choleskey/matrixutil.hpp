@@ -1,31 +1,203 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <experimental/mdspan>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-// generate positive definition matrix
+#include "commons.hpp"
+
+// n x n row-major view over generated matrix storage. 64-bit indices: n * n
+// overflows int past n = 46340.
+template <typename T>
+using matrix_view =
+    std::mdspan<T,
+                std::extents<std::int64_t, std::dynamic_extent,
+                             std::dynamic_extent>,
+                std::layout_right>;
+
+// allocator that default-initializes, so the storage of trivial T is left
+// uninitialized: no serial zero fill, and the parallel generators below do
+// the first touch (pages land on the NUMA node of the thread that fills them)
+template <typename T>
+struct default_init_allocator : std::allocator<T> {
+  template <typename U>
+  struct rebind {
+    using other = default_init_allocator<U>;
+  };
+
+  default_init_allocator() = default;
+  template <typename U>
+  default_init_allocator(default_init_allocator<U> const&) noexcept {}
+
+  template <typename U>
+  void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+    ::new (static_cast<void*>(p)) U;
+  }
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+};
+
+// row-major storage of a generated matrix
+template <typename T>
+using matrix_storage = std::vector<T, default_init_allocator<T>>;
+
+// counter-based random numbers: the value drawn for (seed, k) does not depend
+// on which thread draws it, so the random generators below produce the same
+// matrix for a given seed at any thread count
+inline std::uint64_t splitmix64(std::uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// uniform in [-1, 1)
 template <typename T>
-using Matrix = std::vector<std::vector<T>>;
+T uniform(std::uint64_t seed, std::uint64_t k) {
+  std::uint64_t bits = splitmix64(splitmix64(seed) ^ k) >> 11;
+  return static_cast<T>(bits * 0x1.0p-53 * 2.0 - 1.0);
+}
 
+// generate positive definition matrix. Entries are binomial coefficients and
+// overflow int past n = 18, so use it for small n only.
 template <typename T>
-std::vector<T> generate_pascal_matrix(const int n) {
-  Matrix<T> matrix(n, std::vector<T>(n, static_cast<T>(0)));
+void fill_pascal_matrix(matrix_view<T> a) {
+  std::int64_t n = a.extent(0);
 
-  for (int i = 0; i < n; ++i) {
-    for (int j = 0; j < n; ++j) {
+  for (std::int64_t i = 0; i < n; ++i) {
+    for (std::int64_t j = 0; j < n; ++j) {
       if (i == 0 || j == 0) {
-        matrix[i][j] = static_cast<T>(1);
+        a(i, j) = static_cast<T>(1);
       } else {
-        matrix[i][j] = matrix[i][j - 1] + matrix[i - 1][j];
+        a(i, j) = a(i, j - 1) + a(i - 1, j);
       }
     }
   }
+}
 
-  std::vector<T> flattenedVector;
-  for (const auto& row : matrix) {
-    flattenedVector.insert(flattenedVector.end(), row.begin(), row.end());
-  }
-  return std::move(flattenedVector);
+template <typename T>
+matrix_storage<T> generate_pascal_matrix(const int n) {
+  matrix_storage<T> matrix(std::size_t(n) * n);
+  fill_pascal_matrix(matrix_view<T>(matrix.data(), n, n));
+  return matrix;
+}
+
+// A(i, j) = 1 / (1 + |i - j|) + n * (i == j): dense and well conditioned for
+// any n
+template <typename T>
+void fill_spd_matrix(matrix_view<T> a) {
+  std::int64_t n = a.extent(0);
+
+  for_each_index(std::execution::par, n, [=](auto i) {
+    for (std::int64_t j = 0; j < n; ++j) {
+      a(i, j) = static_cast<T>(1) / static_cast<T>(1 + std::abs(i - j)) +
+                (i == j ? static_cast<T>(n) : static_cast<T>(0));
+    }
+  });
+}
+
+template <typename T>
+matrix_storage<T> generate_spd_matrix(const int n) {
+  matrix_storage<T> matrix(std::size_t(n) * n);
+  fill_spd_matrix(matrix_view<T>(matrix.data(), n, n));
+  return matrix;
+}
+
+// B B^T + n I with B a random n x rank matrix. B B^T is positive semidefinite
+// and the shift makes it definite; a small rank keeps the cost at
+// O(n^2 rank) instead of O(n^3).
+template <typename T>
+void fill_random_spd_matrix(matrix_view<T> a, std::uint64_t seed,
+                            int rank = 32) {
+  std::int64_t n = a.extent(0);
+  std::int64_t r = std::max<std::int64_t>(1, std::min<std::int64_t>(rank, n));
+
+  std::vector<T> b(n * r);
+  T* pb = b.data();
+  for_each_index(std::execution::par, n * r,
+                 [=](auto k) { pb[k] = uniform<T>(seed, k); });
+
+  for_each_index(std::execution::par, n, [=](auto i) {
+    const T* bi = pb + i * r;
+    for (std::int64_t j = 0; j < n; ++j) {
+      const T* bj = pb + j * r;
+      T sum = 0;
+      for (std::int64_t p = 0; p < r; ++p)
+        sum += bi[p] * bj[p];
+      a(i, j) = sum + (i == j ? static_cast<T>(n) : static_cast<T>(0));
+    }
+  });
+}
+
+// 1D Laplacian with Dirichlet boundaries: 2 on the diagonal, -1 next to it
+template <typename T>
+void fill_laplacian_1d(matrix_view<T> a) {
+  std::int64_t n = a.extent(0);
+
+  for_each_index(std::execution::par, n, [=](auto i) {
+    T* row = &a(i, 0);
+    std::fill(row, row + n, static_cast<T>(0));
+    row[i] = 2;
+    if (i > 0)
+      row[i - 1] = -1;
+    if (i + 1 < n)
+      row[i + 1] = -1;
+  });
+}
+
+// 5-point 2D Laplacian with Dirichlet boundaries on a grid of width
+// m = ceil(sqrt(n)) numbered row by row. When n is not a perfect square the
+// last grid row is partial, which keeps the matrix SPD.
+template <typename T>
+void fill_laplacian_2d(matrix_view<T> a) {
+  std::int64_t n = a.extent(0);
+  std::int64_t m = std::ceil(std::sqrt(static_cast<double>(n)));
+
+  for_each_index(std::execution::par, n, [=](auto i) {
+    T* row = &a(i, 0);
+    std::fill(row, row + n, static_cast<T>(0));
+    row[i] = 4;
+    if (i % m > 0)
+      row[i - 1] = -1;
+    if (i % m + 1 < m && i + 1 < n)
+      row[i + 1] = -1;
+    if (i >= m)
+      row[i - m] = -1;
+    if (i + m < n)
+      row[i + m] = -1;
+  });
+}
+
+// symmetric band of half-width bw with random entries in [-1, 1) and
+// 2 * bw + 1 on the diagonal, i.e. strictly diagonally dominant
+template <typename T>
+void fill_banded_matrix(matrix_view<T> a, std::int64_t bw,
+                        std::uint64_t seed) {
+  std::int64_t n = a.extent(0);
+
+  for_each_index(std::execution::par, n, [=](auto i) {
+    T* row = &a(i, 0);
+    std::fill(row, row + n, static_cast<T>(0));
+    std::int64_t lo = std::max<std::int64_t>(0, i - bw);
+    std::int64_t hi = std::min<std::int64_t>(n - 1, i + bw);
+    for (std::int64_t j = lo; j <= hi; ++j) {
+      // draw from the (max, min) pair so that A(i, j) == A(j, i)
+      std::int64_t r = std::max<std::int64_t>(i, j);
+      std::int64_t c = std::min<std::int64_t>(i, j);
+      row[j] = uniform<T>(seed, r * (bw + 1) + (r - c));
+    }
+    row[i] = static_cast<T>(2 * bw + 1);
+  });
 }
 
 // parameters define
@@ -33,9 +205,55 @@ struct args_params_t : public argparse::Args {
   bool& results = kwarg("results", "print generated results (default: false)")
                       .set_default(true);
   std::uint64_t& nd =
-      kwarg("nd", "Number of input(positive definition) matrix dimension(<=18)")
+      kwarg("nd", "Number of input(positive definition) matrix dimension")
           .set_default(10);
+  std::string& matrix =
+      kwarg("matrix",
+            "Input matrix: spd, random, laplace1d, laplace2d, banded or "
+            "pascal (nd <= 18). default: spd, laplace2d for the band variant")
+          .set_default("");
+  std::uint64_t& seed =
+      kwarg("seed", "Seed of the random and banded matrices").set_default(0);
+  std::uint64_t& bw =
+      kwarg("bw", "Half bandwidth of the banded matrix").set_default(8);
   std::uint64_t& np = kwarg("np", "Number of partitions").set_default(4);
+  std::uint64_t& nb =
+      kwarg("nb", "Tile size of the tiled variants").set_default(128);
+  std::uint64_t& nbatch =
+      kwarg("nbatch", "Number of matrices of the batched variant")
+          .set_default(10000);
   bool& help = flag("h, help", "print help");
   bool& time = kwarg("t, time", "print time").set_default(true);
+  bool& solve =
+      kwarg("solve", "time solves with k = 1..1024 right-hand sides")
+          .set_default(false);
 };
+
+// generate the nd x nd input matrix selected by --matrix, row-major
+template <typename T>
+matrix_storage<T> generate_matrix(args_params_t const& args) {
+  std::int64_t n = args.nd;
+  matrix_storage<T> matrix(n * n);
+  matrix_view<T> a(matrix.data(), n, n);
+
+  if (args.matrix == "pascal") {
+    if (n > 18)
+      std::cerr << "WARNING: pascal matrix entries overflow for nd > 18\n";
+    fill_pascal_matrix(a);
+  } else if (args.matrix == "random") {
+    fill_random_spd_matrix(a, args.seed);
+  } else if (args.matrix == "laplace1d") {
+    fill_laplacian_1d(a);
+  } else if (args.matrix == "laplace2d") {
+    fill_laplacian_2d(a);
+  } else if (args.matrix == "banded") {
+    fill_banded_matrix(a, std::int64_t(args.bw), args.seed);
+  } else {
+    if (args.matrix != "spd" && !args.matrix.empty())
+      std::cerr << "WARNING: unknown matrix " << args.matrix
+                << ", using spd\n";
+    fill_spd_matrix(a);
+  }
+
+  return matrix;
+}
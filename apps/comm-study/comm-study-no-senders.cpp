@@ -25,6 +25,7 @@
  */
 
 #include "commons.hpp"
+#include "counting_range.hpp"
 //
 // Build and run on Perlmutter using
 // ml nvhpc/23.1 ; nvc++ -stdpar=gpu -std=c++20 -o nvstdpar.out
@@ -34,6 +35,9 @@
 using T = double;
 using time_point_t = std::chrono::system_clock::time_point;
 
+// 1: evaluate Y lazily inside the reductions instead of storing it
+#define LAZY_Y 1
+
 // must take in the pointers/vectors by reference
 template <typename P>
 auto work(P& A, P& B, P& Y, int N) {
@@ -62,6 +66,25 @@ auto work(P& A, P& B, P& Y, int N) {
 
   std::transform(std::execution::par_unseq, &A[N / 2], &A[N], &B[0], &A[N / 2],
                  [&](T& ai, T& bi) { return ai + bi; });
+#if LAZY_Y
+  // Y(i) is recomputed in each reduction: no temporary array and no D2H copy
+  T* a = &A[N / 2];
+  T* b = &B[0];
+  auto y = as_parallel(
+      counting_range(N / 2) | std::views::transform([=](int i) {
+        return sqrt(pow(a[i], 2) + pow(b[i], 2)) / (a[i] + b[i]);
+      }));
+
+  sum += std::transform_reduce(std::execution::par_unseq, y.begin(),
+                               y.begin() + N / 3, 0.0, std::plus<T>(),
+                               [=](T yi) { return yi / N; });
+
+  std::cout << std::endl;
+
+  // get sum(Y)
+  sum += std::reduce(std::execution::par_unseq, y.begin(), y.end(), 0.0,
+                     std::plus<T>());
+#else
   std::transform(
       std::execution::par_unseq, &A[N / 2], &A[N], &B[0], &Y[0],
       [&](T& ai, T& bi) { return sqrt(pow(ai, 2) + pow(bi, 2)) / (ai + bi); });
@@ -75,6 +98,7 @@ auto work(P& A, P& B, P& Y, int N) {
   // get sum(Y) - one last memcpy (not USM) D2H
   sum +=
       std::reduce(std::execution::par_unseq, &Y[0], &Y[N], 0.0, std::plus<T>());
+#endif  // LAZY_Y
 
   return sum / N;
 }
@@ -25,6 +25,7 @@
  */
 
 #include "commons.hpp"
+#include "counting_range.hpp"
 #include "exec/static_thread_pool.hpp"
 
 using namespace std;
@@ -34,6 +35,9 @@ using stdexec::sync_wait;
 using T = double;
 using time_point_t = std::chrono::system_clock::time_point;
 
+// 1: evaluate Y lazily inside the reductions instead of storing it
+#define LAZY_Y 1
+
 // must take in the pointers/vectors by reference
 template <typename P>
 auto work(P& A, P& B, P& Y, int N) {
@@ -68,6 +72,34 @@ auto work(P& A, P& B, P& Y, int N) {
   sync_wait(when_all(std::move(s1), std::move(s2)));
 
   // compute Y = sqrt((A+B)^2 + B^2)/(A+B+B)
+#if LAZY_Y
+  // Y(i) is recomputed in each reduction: no temporary array and no D2H copy
+  T* a = &A[0];
+  T* b = &B[0];
+  auto y = as_parallel(
+      counting_range(N) | std::views::transform([=](int i) {
+        return sqrt(pow(a[i], 2) + pow(b[i], 2)) / (a[i] + b[i]);
+      }));
+
+  sender auto s3 =
+      then(just(),
+           [&] {
+             std::transform(std::execution::par_unseq, &A[0], &A[N], &B[0],
+                            &A[0], [&](T& ai, T& bi) { return ai + bi; });
+           })
+      | then([&] {
+          sum += std::transform_reduce(std::execution::par_unseq, y.begin(),
+                                       y.begin() + N / 3, 0.0, std::plus<T>(),
+                                       [=](T yi) { return yi / N; });
+
+          std::cout << std::endl;
+        })
+      // get sum(Y)
+      | then([&] {
+          return std::reduce(std::execution::par_unseq, y.begin(), y.end(),
+                             0.0, std::plus<T>());
+        });
+#else
   sender auto s3 =
       then(just(),
            [&] {
@@ -91,6 +123,7 @@ auto work(P& A, P& B, P& Y, int N) {
           return std::reduce(std::execution::par_unseq, &Y[0], &Y[N], 0.0,
                              std::plus<T>());
         });
+#endif  // LAZY_Y
 
   auto [val] = sync_wait(s3).value();
 
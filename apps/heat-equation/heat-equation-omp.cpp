@@ -32,18 +32,16 @@
 #include "heat-equation.hpp"
 
 // fill boundary cells OpenMP
-template <typename T>
-void fill2Dboundaries_omp(T* grid, int len, int nthreads = 1,
-                          int ghost_cells = 1) {
+template <typename View>
+void fill2Dboundaries_omp(View grid, int nthreads = 1, int ghost_cells = 1) {
+  int len = grid.extent(0);
 #pragma omp parallel for num_threads(nthreads)
   for (int i = ghost_cells; i < len - ghost_cells; i++) {
-    grid[i] = grid[i + (ghost_cells * len)];
-    grid[i + (len * (len - ghost_cells))] =
-        grid[i + (len * (len - ghost_cells - 1))];
+    grid(0, i) = grid(ghost_cells, i);
+    grid(len - ghost_cells, i) = grid(len - ghost_cells - 1, i);
 
-    grid[i * len] = grid[(ghost_cells * len) + i];
-    grid[(len - ghost_cells) + (len * i)] =
-        grid[(len - ghost_cells - 1) + (len * i)];
+    grid(i, 0) = grid(i, ghost_cells);
+    grid(i, len - ghost_cells) = grid(i, len - ghost_cells - 1);
   }
 }
 
@@ -66,83 +64,86 @@ int main(int argc, char* argv[]) {
   int nthreads = args.nthreads;
   Real_t dt = args.dt;
   Real_t alpha = args.alpha;
+  // grid row padding (cache lines)
+  int pad = args.pad;
   // future if needed to split in multiple grids
   // int max_grid_size = args.max_grid_size;
 
   // initialize dx, dy, dz
-  auto* dx = new Real_t[dims];
+  std::array<Real_t, dims> dx;
   for (int i = 0; i < dims; ++i)
     dx[i] = 1.0 / (ncells - 1);
 
-  // simulation setup (2D)
-  Real_t* grid_old = new Real_t[(ncells + nghosts) * (ncells + nghosts)];
-  Real_t* grid_new = new Real_t[(ncells) * (ncells)];
+  // simulation setup (2D), rows padded to avoid cache-set aliasing
+  auto old_mapping = padded_mapping<Real_t>(
+      view_2d_64(ncells + nghosts, ncells + nghosts), pad);
+  auto new_mapping = padded_mapping<Real_t>(view_2d_64(ncells, ncells), pad);
+  Real_t* grid_old = aligned_new<Real_t>(old_mapping.required_span_size());
+  Real_t* grid_new = aligned_new<Real_t>(new_mapping.required_span_size());
 
-  auto phi_old = std::mdspan<Real_t, view_2d, std::layout_right>(
-      grid_old, ncells + nghosts, ncells + nghosts);
-  auto phi_new =
-      std::mdspan<Real_t, view_2d, std::layout_right>(grid_new, ncells, ncells);
-
-  int gsize = ncells * ncells;
+  std::int64_t gsize = std::int64_t(ncells) * ncells;
 
   Timer timer;
 
-  // initialize phi_old domain: {[-0.5, -0.5], [0.5, 0.5]} -> origin at [0,0]
+  // use static extents for the specialized grid sizes so that the index math
+  // and the coefficients are folded at compile time
+  dispatch_ncells(ncells, pad, [&](auto old_extents, auto new_extents,
+                                  auto row_pad) {
+    auto phi_old = make_aligned_view(grid_old, old_extents, row_pad);
+    auto phi_new = make_aligned_view(grid_new, new_extents, row_pad);
+
+    // alpha * dt / dx^2
+    Real_t coeff = alpha * dt * inv_dx2(new_extents);
+
+    // initialize phi_old domain: {[-0.5, -0.5], [0.5, 0.5]} -> origin at [0,0]
 #pragma omp parallel for num_threads(nthreads)
-  for (int pos = 0; pos < gsize; pos++) {
-    int i = 1 + (pos / ncells);
-    int j = 1 + (pos % ncells);
+    for (std::int64_t pos = 0; pos < gsize; pos++) {
+      int i = 1 + (pos / phi_new.extent(1));
+      int j = 1 + (pos % phi_new.extent(1));
 
-    Real_t x = pos(i, ghost_cells, dx[0]);
-    Real_t y = pos(j, ghost_cells, dx[1]);
+      Real_t x = pos(i, ghost_cells, dx[0]);
+      Real_t y = pos(j, ghost_cells, dx[1]);
 
-    // L2 distance (r2 from origin)
-    Real_t r2 = (x * x + y * y) / (0.01);
+      // L2 distance (r2 from origin)
+      Real_t r2 = (x * x + y * y) / (0.01);
 
-    // phi(x,y) = 1 + exp(-r^2)
-    phi_old(i, j) = 1 + exp(-r2);
-  }
+      // phi(x,y) = 1 + exp(-r^2)
+      phi_old(i, j) = 1 + exp(-r2);
+    }
 
-  if (args.print_grid)
-    // print the initial grid
-    printGrid(grid_old, ncells + nghosts);
+    if (args.print_grid)
+      // print the initial grid
+      printGrid(phi_old);
 
-  // init simulation time
-  Real_t time = 0.0;
+    // init simulation time
+    Real_t time = 0.0;
 
-  // evolve the system
-  for (auto step = 0; step < nsteps; step++) {
-    // fill boundary cells in old_phi
-    fill2Dboundaries_omp(grid_old, ncells + nghosts, ghost_cells, nthreads);
+    // evolve the system
+    for (auto step = 0; step < nsteps; step++) {
+      // fill boundary cells in old_phi
+      fill2Dboundaries_omp(phi_old, nthreads, ghost_cells);
 
+      // Jacobi iteration, one row of phi_new per iteration
+      int rows = phi_new.extent(0);
+      int cols = phi_new.extent(1);
 #pragma omp parallel for num_threads(nthreads)
-    for (int pos = 0; pos < gsize; pos++) {
-      int i = 1 + (pos / ncells);
-      int j = 1 + (pos % ncells);
-
-      // Jacobi iteration
-      phi_new(i - 1, j - 1) =
-          phi_old(i, j) +
-          alpha * dt *
-              ((phi_old(i + 1, j) - 2.0 * phi_old(i, j) + phi_old(i - 1, j)) /
-                   (dx[0] * dx[0]) +
-               (phi_old(i, j + 1) - 2.0 * phi_old(i, j) + phi_old(i, j - 1)) /
-                   (dx[1] * dx[1]));
-    }
+      for (int i = 0; i < rows; i++)
+        heat_tile(phi_old, phi_new, tile_t{i, i + 1, 0, cols}, coeff);
 
-    // update the simulation time
-    time += dt;
+      // update the simulation time
+      time += dt;
 
-    // parallel copy phi_new to phi_old
+      // parallel copy phi_new to phi_old
 #pragma omp parallel for num_threads(nthreads)
-    for (int pos = 0; pos < gsize; pos++) {
-      int i = 1 + (pos / ncells);
-      int j = 1 + (pos % ncells);
+      for (std::int64_t pos = 0; pos < gsize; pos++) {
+        int i = 1 + (pos / phi_new.extent(1));
+        int j = 1 + (pos % phi_new.extent(1));
 
-      // copy phi_new to phi_old
-      phi_old(i, j) = phi_new(i - 1, j - 1);
+        // copy phi_new to phi_old
+        phi_old(i, j) = phi_new(i - 1, j - 1);
+      }
     }
-  }
+  });
 
   auto elapsed = timer.stop();
 
@@ -153,11 +154,11 @@ int main(int argc, char* argv[]) {
 
   if (args.print_grid)
     // print the final grid
-    printGrid(grid_new, ncells);
+    printGrid(make_aligned_view(grid_new, view_2d_64(ncells, ncells), pad));
 
   // delete all memory
-  delete[] grid_old;
-  delete[] grid_new;
+  aligned_delete(grid_old);
+  aligned_delete(grid_new);
 
   grid_old = nullptr;
   grid_new = nullptr;
@@ -31,6 +31,7 @@
 // define this macro before including heat-equation.hpp to enable tiled parallel
 // execution
 #define TILING
+#define SFC_TILING
 
 #include <stdexec/execution.hpp>
 
@@ -59,8 +60,12 @@ int main(int argc, char* argv[]) {
   int nsteps = args.nsteps;
   // number of parallel tiles
   int ntiles = args.ntiles;
+  // square tiles in space-filling-curve order
+  sfc_t curve = to_sfc(args.sfc);
   Real_t dt = args.dt;
   Real_t alpha = args.alpha;
+  // grid row padding (cache lines)
+  int pad = args.pad;
   // future if needed to split in multiple grids
   // int max_grid_size = args.max_grid_size;
 
@@ -68,18 +73,26 @@ int main(int argc, char* argv[]) {
   Real_t time = 0.0;
 
   // initialize dx, dy, dz
-  auto* dx = new Real_t[dims];
+  std::array<Real_t, dims> dx;
   for (int i = 0; i < dims; ++i)
     dx[i] = 1.0 / (ncells - 1);
 
-  // simulation setup (2D)
-  Real_t* grid_old = new Real_t[(ncells + nghosts) * (ncells + nghosts)];
-  Real_t* grid_new = new Real_t[(ncells) * (ncells)];
+  // simulation setup (2D), rows padded to avoid cache-set aliasing
+  auto old_mapping = padded_mapping<Real_t>(
+      view_2d_64(ncells + nghosts, ncells + nghosts), pad);
+  auto new_mapping = padded_mapping<Real_t>(view_2d_64(ncells, ncells), pad);
+  Real_t* grid_old = aligned_new<Real_t>(old_mapping.required_span_size());
+  Real_t* grid_new = aligned_new<Real_t>(new_mapping.required_span_size());
 
-  auto phi_old = std::mdspan<Real_t, view_2d, std::layout_right>(
-      grid_old, ncells + nghosts, ncells + nghosts);
-  auto phi_new =
-      std::mdspan<Real_t, view_2d, std::layout_right>(grid_new, ncells, ncells);
+  std::int64_t gsize = std::int64_t(ncells) * ncells;
+
+  // square tiles ordered along the curve. each parallel tile (worker) takes
+  // a contiguous run of them so that it sweeps a compact 2D region
+  std::vector<tile_t> sfc_tiles;
+  if (curve != sfc_t::none)
+    sfc_tiles = make_tiles(ncells, args.tile_size, curve);
+  tile_t* tiles_ptr = sfc_tiles.data();
+  int nsfc_tiles = sfc_tiles.size();
 
   Timer timer;
 
@@ -89,97 +102,127 @@ int main(int argc, char* argv[]) {
   scheduler auto sch = ctx.get_scheduler();
   sender auto begin = schedule(sch);
 
-  // initialize phi_old domain: {[-0.5, -0.5], [0.5, 0.5]} -> origin at [0,0]
-  sender auto heat_eq_init =
-      bulk(begin, ntiles,
-           [&](int tile) {
-             int start = tile * (ncells * ncells) / ntiles;
-             int size = (ncells * ncells) / ntiles;
-             int remaining = (ncells * ncells) % ntiles;
-             size += (tile == ntiles - 1) ? remaining : 0;
-
-             std::for_each_n(std::execution::par_unseq,
-                             counting_iterator(start), size, [=](int pos) {
-                               int i = 1 + (pos / ncells);
-                               int j = 1 + (pos % ncells);
-
-                               Real_t x = pos(i, ghost_cells, dx[0]);
-                               Real_t y = pos(j, ghost_cells, dx[1]);
-
-                               // L2 distance (r2 from origin)
-                               Real_t r2 = (x * x + y * y) / (0.01);
-
-                               // phi(x,y) = 1 + exp(-r^2)
-                               phi_old(i, j) = 1 + exp(-r2);
-                             });
-           }) |
-      then([&]() {
-        if (args.print_grid)
-          // print the initial grid
-          printGrid(grid_old, ncells + nghosts);
-      });
+  // use static extents for the specialized grid sizes so that the index math
+  // and the coefficients are folded at compile time
+  dispatch_ncells(ncells, pad, [&](auto old_extents, auto new_extents,
+                                  auto row_pad) {
+    auto phi_old = make_aligned_view(grid_old, old_extents, row_pad);
+    auto phi_new = make_aligned_view(grid_new, new_extents, row_pad);
 
-  // start the simulation
-  sync_wait(std::move(heat_eq_init));
-
-  // evolve the system
-  for (auto step = 0; step < nsteps; step++) {
-    static sender auto evolve =
-        then(begin,
-             [&]() {
-               // fill boundary cells in old_phi
-               fill2Dboundaries(grid_old, ncells + nghosts, ghost_cells);
-             }) |
-        bulk(ntiles,
+    // alpha * dt / dx^2
+    Real_t coeff = alpha * dt * inv_dx2(new_extents);
+
+    // initialize phi_old domain: {[-0.5, -0.5], [0.5, 0.5]} -> origin at [0,0]
+    sender auto heat_eq_init =
+        bulk(begin, ntiles,
              [&](int tile) {
-               int start = tile * (ncells * ncells) / ntiles;
-               int size = (ncells * ncells) / ntiles;
-               int remaining = (ncells * ncells) % ntiles;
+               std::int64_t start = tile * gsize / ntiles;
+               std::int64_t size = gsize / ntiles;
+               std::int64_t remaining = gsize % ntiles;
                size += (tile == ntiles - 1) ? remaining : 0;
 
-               // update phi_new with stencil
                std::for_each_n(
-                   std::execution::par_unseq, counting_iterator(start), size,
-                   [=](int pos) {
-                     int i = 1 + (pos / ncells);
-                     int j = 1 + (pos % ncells);
-
-                     // Jacobi iteration
-                     phi_new(i - 1, j - 1) =
-                         phi_old(i, j) +
-                         alpha * dt *
-                             ((phi_old(i + 1, j) - 2.0 * phi_old(i, j) +
-                               phi_old(i - 1, j)) /
-                                  (dx[0] * dx[0]) +
-                              (phi_old(i, j + 1) - 2.0 * phi_old(i, j) +
-                               phi_old(i, j - 1)) /
-                                  (dx[1] * dx[1]));
-                   });
-             }) |
-        bulk(ntiles,
-             [&](int tile) {
-               int start = tile * (ncells * ncells) / ntiles;
-               int size = (ncells * ncells) / ntiles;
-               int remaining = (ncells * ncells) % ntiles;
-               size += (tile == ntiles - 1) ? remaining : 0;
+                   std::execution::par_unseq,
+                   md_counting_iterator(new_extents, start), size,
+                   [=](auto ij) {
+                     int i = 1 + ij[0];
+                     int j = 1 + ij[1];
+
+                     Real_t x = pos(i, ghost_cells, dx[0]);
+                     Real_t y = pos(j, ghost_cells, dx[1]);
 
-               // parallel copy phi_new to phi_old
-               std::for_each_n(std::execution::par_unseq,
-                               counting_iterator(start), size, [=](int pos) {
-                                 int i = 1 + (pos / ncells);
-                                 int j = 1 + (pos % ncells);
+                     // L2 distance (r2 from origin)
+                     Real_t r2 = (x * x + y * y) / (0.01);
 
-                                 // copy phi_new to phi_old
-                                 phi_old(i, j) = phi_new(i - 1, j - 1);
-                               });
+                     // phi(x,y) = 1 + exp(-r^2)
+                     phi_old(i, j) = 1 + exp(-r2);
+                   });
              }) |
         then([&]() {
-          // update the simulation time
-          time += dt;
+          if (args.print_grid)
+            // print the initial grid
+            printGrid(phi_old);
         });
 
-    sync_wait(std::move(evolve));
-  }
+    // start the simulation
+    sync_wait(std::move(heat_eq_init));
+
+    // evolve the system
+    for (auto step = 0; step < nsteps; step++) {
+      static sender auto evolve =
+          then(begin,
+               [&]() {
+                 // fill boundary cells in old_phi
+                 fill2Dboundaries(phi_old, ghost_cells);
+               }) |
+          bulk(ntiles,
+               [&](int tile) {
+                 if (curve != sfc_t::none) {
+                   int first = tile * nsfc_tiles / ntiles;
+                   int last = (tile + 1) * nsfc_tiles / ntiles;
+
+                   // update phi_new with stencil (Jacobi iteration)
+                   for (int t = first; t < last; ++t)
+                     heat_tile(phi_old, phi_new, tiles_ptr[t], coeff);
+                   return;
+                 }
+
+                 std::int64_t start = tile * gsize / ntiles;
+                 std::int64_t size = gsize / ntiles;
+                 std::int64_t remaining = gsize % ntiles;
+                 size += (tile == ntiles - 1) ? remaining : 0;
+
+                 // update phi_new with stencil
+                 std::for_each_n(
+                     std::execution::par_unseq,
+                     md_counting_iterator(new_extents, start), size,
+                     [=](auto ij) {
+                       int i = 1 + ij[0];
+                       int j = 1 + ij[1];
+
+                       // Jacobi iteration
+                       heat_kernel(phi_old, phi_new, i, j, coeff);
+                     });
+               }) |
+          bulk(ntiles,
+               [&](int tile) {
+                 if (curve != sfc_t::none) {
+                   int first = tile * nsfc_tiles / ntiles;
+                   int last = (tile + 1) * nsfc_tiles / ntiles;
+
+                   // copy phi_new to phi_old
+                   for (int t = first; t < last; ++t)
+                     for_each_in_tile(tiles_ptr[t], [=](int i, int j) {
+                       phi_old(i, j) = phi_new(i - 1, j - 1);
+                     });
+                   return;
+                 }
+
+                 std::int64_t start = tile * gsize / ntiles;
+                 std::int64_t size = gsize / ntiles;
+                 std::int64_t remaining = gsize % ntiles;
+                 size += (tile == ntiles - 1) ? remaining : 0;
+
+                 // parallel copy phi_new to phi_old
+                 std::for_each_n(
+                     std::execution::par_unseq,
+                     md_counting_iterator(new_extents, start), size,
+                     [=](auto ij) {
+                       int i = 1 + ij[0];
+                       int j = 1 + ij[1];
+
+                       // copy phi_new to phi_old
+                       phi_old(i, j) = phi_new(i - 1, j - 1);
+                     });
+               }) |
+          then([&]() {
+            // update the simulation time
+            time += dt;
+          });
+
+      sync_wait(std::move(evolve));
+    }
+  });
 
   auto elapsed = timer.stop();
 
@@ -192,12 +235,14 @@ int main(int argc, char* argv[]) {
                               [&]() {
                                 if (args.print_grid)
                                   // print the final grid
-                                  printGrid(grid_new, ncells);
+                                  printGrid(make_aligned_view(
+                                      grid_new, view_2d_64(ncells, ncells),
+                                      pad));
                               }) |
                          then([&]() {
                            // delete all memory
-                           delete[] grid_old;
-                           delete[] grid_new;
+                           aligned_delete(grid_old);
+                           aligned_delete(grid_new);
 
                            grid_old = nullptr;
                            grid_new = nullptr;
@@ -28,6 +28,10 @@
  * Simplified 2d heat equation example derived from amrex
  */
 
+// define this macro before including heat-equation.hpp to enable square tiles
+// traversed along a space-filling curve (--sfc)
+#define SFC_TILING
+
 #include "heat-equation.hpp"
 
 //
@@ -48,85 +52,122 @@ int main(int argc, char* argv[]) {
   int nsteps = args.nsteps;
   Real_t dt = args.dt;
   Real_t alpha = args.alpha;
+  // grid row padding (cache lines)
+  int pad = args.pad;
+  // square tiles in space-filling-curve order
+  sfc_t curve = to_sfc(args.sfc);
   // future if needed to split in multiple grids
   // int max_grid_size = args.max_grid_size;
 
   // initialize dx, dy, dz
-  auto* dx = new Real_t[dims];
+  std::array<Real_t, dims> dx;
   for (int i = 0; i < dims; ++i)
     dx[i] = 1.0 / (ncells - 1);
 
-  // simulation setup (2D)
-  Real_t* grid_old = new Real_t[(ncells + nghosts) * (ncells + nghosts)];
-  Real_t* grid_new = new Real_t[(ncells) * (ncells)];
+  // simulation setup (2D), rows padded to avoid cache-set aliasing
+  auto old_mapping = padded_mapping<Real_t>(
+      view_2d_64(ncells + nghosts, ncells + nghosts), pad);
+  auto new_mapping = padded_mapping<Real_t>(view_2d_64(ncells, ncells), pad);
+  Real_t* grid_old = aligned_new<Real_t>(old_mapping.required_span_size());
+  Real_t* grid_new = aligned_new<Real_t>(new_mapping.required_span_size());
 
-  auto phi_old = std::mdspan<Real_t, view_2d, std::layout_right>(
-      grid_old, ncells + nghosts, ncells + nghosts);
-  auto phi_new =
-      std::mdspan<Real_t, view_2d, std::layout_right>(grid_new, ncells, ncells);
+  std::int64_t gsize = std::int64_t(ncells) * ncells;
 
-  // initialize phi_old domain: {[-0.5, -0.5], [0.5, 0.5]} -> origin at [0,0]
+  // tiles ordered along the curve so that neighbouring tiles, which share
+  // ghost rows, are processed close in time
+  std::vector<tile_t> tiles;
+  if (curve != sfc_t::none)
+    tiles = make_tiles(ncells, args.tile_size, curve);
+  tile_t* tiles_ptr = tiles.data();
+  int ntiles = tiles.size();
 
   Timer timer;
 
-  std::for_each_n(std::execution::par_unseq, counting_iterator(0),
-                  ncells * ncells, [=](int ind) {
-                    int i = 1 + (ind / ncells);
-                    int j = 1 + (ind % ncells);
-
-                    Real_t x = pos(i, ghost_cells, dx[0]);
-                    Real_t y = pos(j, ghost_cells, dx[1]);
+  // use static extents for the specialized grid sizes so that the index math
+  // and the coefficients are folded at compile time
+  dispatch_ncells(ncells, pad, [&](auto old_extents, auto new_extents,
+                                  auto row_pad) {
+    auto phi_old = make_aligned_view(grid_old, old_extents, row_pad);
+    auto phi_new = make_aligned_view(grid_new, new_extents, row_pad);
 
-                    // L2 distance (r2 from origin)
-                    Real_t r2 = (x * x + y * y) / (0.01);
+    // alpha * dt / dx^2
+    Real_t coeff = alpha * dt * inv_dx2(new_extents);
 
-                    // phi(x,y) = 1 + exp(-r^2)
-                    phi_old(i, j) = 1 + exp(-r2);
-                  });
+    // initialize phi_old domain: {[-0.5, -0.5], [0.5, 0.5]} -> origin at [0,0]
+    std::for_each_n(std::execution::par_unseq,
+                    md_counting_iterator(new_extents), gsize,
+                    [=](auto ij) {
+                      int i = 1 + ij[0];
+                      int j = 1 + ij[1];
 
-  if (args.print_grid)
-    // print the initial grid
-    printGrid(grid_old, ncells + nghosts);
-
-  // init simulation time
-  Real_t time = 0.0;
-
-  // evolve the system
-  for (auto step = 0; step < nsteps; step++) {
-    // fill boundary cells in old_phi
-    fill2Dboundaries(grid_old, ncells + nghosts, ghost_cells);
-
-    // update phi_new with stencil
-    std::for_each_n(std::execution::par_unseq, counting_iterator(0),
-                    ncells * ncells, [=](int ind) {
-                      int i = 1 + (ind / ncells);
-                      int j = 1 + (ind % ncells);
-
-                      // Jacobi iteration
-                      phi_new(i - 1, j - 1) =
-                          phi_old(i, j) +
-                          alpha * dt *
-                              ((phi_old(i + 1, j) - 2.0 * phi_old(i, j) +
-                                phi_old(i - 1, j)) /
-                                   (dx[0] * dx[0]) +
-                               (phi_old(i, j + 1) - 2.0 * phi_old(i, j) +
-                                phi_old(i, j - 1)) /
-                                   (dx[1] * dx[1]));
-                    });
+                      Real_t x = pos(i, ghost_cells, dx[0]);
+                      Real_t y = pos(j, ghost_cells, dx[1]);
 
-    // update the simulation time
-    time += dt;
+                      // L2 distance (r2 from origin)
+                      Real_t r2 = (x * x + y * y) / (0.01);
 
-    // parallel copy phi_new to phi_old
-    std::for_each_n(std::execution::par_unseq, counting_iterator(0),
-                    ncells * ncells, [=](int ind) {
-                      int i = 1 + (ind / ncells);
-                      int j = 1 + (ind % ncells);
-
-                      // copy phi_new to phi_old
-                      phi_old(i, j) = phi_new(i - 1, j - 1);
+                      // phi(x,y) = 1 + exp(-r^2)
+                      phi_old(i, j) = 1 + exp(-r2);
                     });
-  }
+
+    if (args.print_grid)
+      // print the initial grid
+      printGrid(phi_old);
+
+    // init simulation time
+    Real_t time = 0.0;
+
+    // evolve the system
+    for (auto step = 0; step < nsteps; step++) {
+      // fill boundary cells in old_phi
+      fill2Dboundaries(phi_old, ghost_cells);
+
+      if (curve == sfc_t::none) {
+        // update phi_new with stencil
+        std::for_each_n(std::execution::par_unseq,
+                        md_counting_iterator(new_extents), gsize,
+                        [=](auto ij) {
+                          int i = 1 + ij[0];
+                          int j = 1 + ij[1];
+
+                          // Jacobi iteration
+                          heat_kernel(phi_old, phi_new, i, j, coeff);
+                        });
+      } else {
+        // update phi_new with stencil, one tile per task
+        std::for_each_n(std::execution::par_unseq, counting_iterator(0),
+                        ntiles, [=](int t) {
+                          // Jacobi iteration
+                          heat_tile(phi_old, phi_new, tiles_ptr[t], coeff);
+                        });
+      }
+
+      // update the simulation time
+      time += dt;
+
+      if (curve == sfc_t::none) {
+        // parallel copy phi_new to phi_old
+        std::for_each_n(std::execution::par_unseq,
+                        md_counting_iterator(new_extents), gsize,
+                        [=](auto ij) {
+                          int i = 1 + ij[0];
+                          int j = 1 + ij[1];
+
+                          // copy phi_new to phi_old
+                          phi_old(i, j) = phi_new(i - 1, j - 1);
+                        });
+      } else {
+        // parallel copy phi_new to phi_old, one tile per task
+        std::for_each_n(std::execution::par_unseq, counting_iterator(0),
+                        ntiles, [=](int t) {
+                          for_each_in_tile(tiles_ptr[t], [=](int i, int j) {
+                            // copy phi_new to phi_old
+                            phi_old(i, j) = phi_new(i - 1, j - 1);
+                          });
+                        });
+      }
+    }
+  });
 
   auto elapsed = timer.stop();
 
@@ -137,11 +178,11 @@ int main(int argc, char* argv[]) {
 
   if (args.print_grid)
     // print the final grid
-    printGrid(grid_new, ncells);
+    printGrid(make_aligned_view(grid_new, view_2d_64(ncells, ncells), pad));
 
   // delete all memory
-  delete[] grid_old;
-  delete[] grid_new;
+  aligned_delete(grid_old);
+  aligned_delete(grid_new);
 
   grid_old = nullptr;
   grid_new = nullptr;
@@ -32,8 +32,11 @@
 
 #include <experimental/mdspan>
 
+#include "aligned_accessor.hpp"
 #include "argparse/argparse.hpp"
 #include "commons.hpp"
+#include "md_counting_iterator.hpp"
+#include "space_filling_curve.hpp"
 
 // data type
 using Real_t = double;
@@ -48,10 +51,21 @@ constexpr int nghosts = ghost_cells * dims;
 // 2D view
 using view_2d = std::extents<int, std::dynamic_extent, std::dynamic_extent>;
 
+// 2D view with 64-bit indices, for grids with more than 2^31 cells
+using view_2d_64 =
+    std::extents<std::int64_t, std::dynamic_extent, std::dynamic_extent>;
+
 // 3D view
 using view_3d = std::extents<int, std::dynamic_extent, std::dynamic_extent,
                              std::dynamic_extent>;
 
+// 2D view with compile-time extents
+template <int N>
+using static_view_2d = std::extents<int, N, N>;
+
+// grid sizes (ncells) for which the kernels are compiled with static extents
+using static_ncells_t = std::integer_sequence<int, 1024, 4096, 16384>;
+
 // macros to get x and y positions from indices
 #define pos(i, ghosts, dx) -0.5 + dx*(i - ghosts)
 
@@ -68,9 +82,20 @@ struct heat_params_t : public argparse::Args {
   bool& help = flag("h, help", "print help");
   bool& print_grid = flag("p,print", "print grids at step 0 and step n");
   bool& print_time = flag("time", "print simulation time");
+  int& pad = kwarg("pad",
+                    "extra cache lines per grid row (0: none, -1: automatic)")
+                 .set_default(-1);
 #if defined(TILING)
   int& ntiles = kwarg("ntiles", "number of parallel tiles").set_default(4);
-#endif  // TILING               \
+#endif  // TILING
+#if defined(SFC_TILING)
+  std::string& sfc =
+      kwarg("sfc", "square tile traversal order: none, morton, hilbert")
+          .set_default("none");
+  int& tile_size =
+      kwarg("tile", "side of the square tiles (cells) used with --sfc")
+          .set_default(64);
+#endif  // SFC_TILING           \
         // future use if needed \
         // int &max_grid_size = kwarg("g, max_grid_size", "size of each box (or
   // grid)").set_default(32); bool &verbose = kwarg("v, verbose", "verbose
@@ -78,9 +103,8 @@ struct heat_params_t : public argparse::Args {
   // to write a plotfile").set_default(-1);
 };
 
-template <typename T>
-void printGrid(T* grid, int len) {
-  auto view = std::mdspan<T, view_2d, std::layout_right>(grid, len, len);
+template <typename View>
+void printGrid(View view) {
   std::cout << "Grid: " << std::endl;
   std::cout << std::fixed << std::showpoint;
   std::cout << std::setprecision(2);
@@ -94,17 +118,142 @@ void printGrid(T* grid, int len) {
   std::cout << std::endl;
 }
 
-// fill boundary cells
 template <typename T>
-void fill2Dboundaries(T* grid, int len, int ghost_cells = 1) {
+void printGrid(T* grid, int len) {
+  printGrid(std::mdspan<T, view_2d_64, std::layout_right>(grid, len, len));
+}
+
+// fill boundary cells
+template <typename View>
+void fill2Dboundaries(View grid, int ghost_cells = 1) {
+  int len = grid.extent(0);
   std::for_each_n(std::execution::par_unseq, counting_iterator(ghost_cells),
                   len - nghosts, [=](auto i) {
-                    grid[i] = grid[i + (ghost_cells * len)];
-                    grid[i + (len * (len - ghost_cells))] =
-                        grid[i + (len * (len - ghost_cells - 1))];
+                    grid(0, i) = grid(ghost_cells, i);
+                    grid(len - ghost_cells, i) =
+                        grid(len - ghost_cells - 1, i);
 
-                    grid[i * len] = grid[(ghost_cells * len) + i];
-                    grid[(len - ghost_cells) + (len * i)] =
-                        grid[(len - ghost_cells - 1) + (len * i)];
+                    grid(i, 0) = grid(i, ghost_cells);
+                    grid(i, len - ghost_cells) =
+                        grid(i, len - ghost_cells - 1);
                   });
-}
\ No newline at end of file
+}
+
+// 1 / dx^2 for dx = 1 / (ncells - 1), folded at compile time for static extents
+template <typename Extents>
+constexpr Real_t inv_dx2(Extents const& ext) {
+  if constexpr (Extents::rank_dynamic() == 0) {
+    constexpr Real_t n = Extents::static_extent(0) - 1;
+    return n * n;
+  } else {
+    Real_t n = ext.extent(0) - 1;
+    return n * n;
+  }
+}
+
+// Jacobi update of phi_new(i-1, j-1) from phi_old(i, j). coeff = alpha * dt /
+// dx^2 (dx == dy)
+template <typename OldView, typename NewView>
+inline void heat_kernel(OldView phi_old, NewView phi_new, int i, int j,
+                        Real_t coeff) {
+  phi_new(i - 1, j - 1) =
+      phi_old(i, j) + coeff * (phi_old(i + 1, j) + phi_old(i - 1, j) +
+                               phi_old(i, j + 1) + phi_old(i, j - 1) -
+                               4.0 * phi_old(i, j));
+}
+
+// heat_kernel along n cells of a row: out from the rows up, mid and down of
+// phi_old. out lies in phi_new, so it never overlaps the inputs; the restrict
+// qualifiers tell the compiler so, and the loop vectorizes without a runtime
+// overlap check
+inline void heat_row(Real_t* __restrict out, const Real_t* __restrict up,
+                     const Real_t* __restrict mid,
+                     const Real_t* __restrict down, int n, Real_t coeff) {
+  for (int j = 0; j < n; ++j)
+    out[j] = mid[j] + coeff * (down[j] + up[j] + mid[j + 1] + mid[j - 1] -
+                               4.0 * mid[j]);
+}
+
+// square tile of phi_new: rows [i0, i1) and columns [j0, j1)
+struct tile_t {
+  int i0, i1;
+  int j0, j1;
+};
+
+// split the ncells x ncells grid into tile x tile tiles, ordered along curve
+inline std::vector<tile_t> make_tiles(int ncells, int tile, sfc_t curve) {
+  int ntx = (ncells + tile - 1) / tile;
+  std::vector<tile_t> tiles;
+  tiles.reserve(ntx * ntx);
+
+  for (auto [tx, ty] : sfc_order(ntx, ntx, curve))
+    tiles.push_back({ty * tile, std::min((ty + 1) * tile, ncells), tx * tile,
+                     std::min((tx + 1) * tile, ncells)});
+
+  return tiles;
+}
+
+// call f(i, j) for every cell of the tile in phi_old (ghosted) indices
+template <typename F>
+inline void for_each_in_tile(tile_t const& t, F&& f) {
+  for (int i = t.i0; i < t.i1; ++i)
+    for (int j = t.j0; j < t.j1; ++j)
+      f(1 + i, 1 + j);
+}
+
+// heat_kernel on every cell of the tile, one heat_row per row. the views must
+// have unit stride along a row
+template <typename OldView, typename NewView>
+inline void heat_tile(OldView phi_old, NewView phi_new, tile_t const& t,
+                      Real_t coeff) {
+  for (int i = 1 + t.i0; i < 1 + t.i1; ++i)
+    heat_row(&phi_new(i - 1, t.j0), &phi_old(i - 1, 1 + t.j0),
+             &phi_old(i, 1 + t.j0), &phi_old(i + 1, 1 + t.j0), t.j1 - t.j0,
+             coeff);
+}
+
+// call f(old_extents, new_extents, pad) with static extents if ncells is one
+// of Ns and the rows are unpadded or automatically padded, or with dynamic
+// extents otherwise. the dynamic extents keep 32-bit indices unless the
+// ghosted grid has more than 2^31 - 1 cells. pad is passed on as a static_pad
+// where it can be, so that make_aligned_view picks layout_right for unpadded
+// grids and a compile-time row stride for the static extents
+template <int... Ns, typename F>
+void dispatch_ncells(std::integer_sequence<int, Ns...>, int ncells, int pad,
+                     F&& f) {
+  auto with_pad = [&](auto old_extents, auto new_extents) {
+    if (pad == 0)
+      f(old_extents, new_extents, static_pad<0>{});
+    else
+      f(old_extents, new_extents, static_pad<-1>{});
+    return true;
+  };
+
+  bool found =
+      pad <= 0 &&
+      ((ncells == Ns
+            ? with_pad(static_view_2d<Ns + nghosts>{}, static_view_2d<Ns>{})
+            : false) ||
+       ...);
+
+  if (found)
+    return;
+
+  std::int64_t len = ncells + nghosts;
+  auto dynamic = [&](auto old_extents, auto new_extents) {
+    if (pad == 0)
+      f(old_extents, new_extents, static_pad<0>{});
+    else
+      f(old_extents, new_extents, pad);
+  };
+
+  if (len * len <= INT32_MAX)
+    dynamic(view_2d(len, len), view_2d(ncells, ncells));
+  else
+    dynamic(view_2d_64(len, len), view_2d_64(ncells, ncells));
+}
+
+template <typename F>
+void dispatch_ncells(int ncells, int pad, F&& f) {
+  dispatch_ncells(static_ncells_t{}, ncells, pad, std::forward<F>(f));
+}
@@ -0,0 +1,262 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// mdspan accessor for aligned data and padded row-major layouts
+//
+
+#pragma once
+
+#include <experimental/mdspan>
+
+#include "commons.hpp"
+
+// cache line size in bytes
+constexpr std::size_t cache_line = 64;
+
+// mdspan accessor that promises the data handle is aligned to Align bytes
+template <typename T, std::size_t Align = cache_line>
+struct aligned_accessor {
+  using offset_policy = std::default_accessor<T>;
+  using element_type = T;
+  using reference = T&;
+  using data_handle_type = T*;
+
+  static constexpr std::size_t alignment = Align;
+
+  constexpr aligned_accessor() noexcept = default;
+
+  reference access(data_handle_type p, std::size_t i) const noexcept {
+    return std::assume_aligned<Align>(p)[i];
+  }
+
+  typename offset_policy::data_handle_type offset(
+      data_handle_type p, std::size_t i) const noexcept {
+    return p + i;
+  }
+};
+
+// n rounded up to a multiple of the cache line (in elements of T) plus pad
+// extra cache lines, or n itself if pad is 0 (unpadded rows). pad < 0 picks
+// the padding automatically: the stride is made an odd number of cache lines
+// so that consecutive rows spread across the cache sets instead of aliasing
+// at power-of-two sizes
+template <typename T>
+constexpr std::size_t padded_stride(std::size_t n, int pad = 0) {
+  constexpr std::size_t line = std::max<std::size_t>(cache_line / sizeof(T), 1);
+  std::size_t lines = (n + line - 1) / line;
+
+  if (pad == 0)
+    return n;
+
+  if (pad < 0)
+    lines += (lines > 1 && lines % 2 == 0) ? 1 : 0;
+  else
+    lines += pad;
+
+  return lines * line;
+}
+
+// row-major layout whose rows (last extent) are RowStride elements apart, or
+// a row stride given at run time for dynamic_extent. unlike layout_stride the
+// unit stride of the last extent is a compile-time constant, and with static
+// extents and a static RowStride all of the index math folds at compile time
+template <std::size_t RowStride = std::dynamic_extent>
+struct layout_padded {
+  template <typename Extents>
+  class mapping {
+   public:
+    using extents_type = Extents;
+    using index_type = typename Extents::index_type;
+    using size_type = typename Extents::size_type;
+    using rank_type = typename Extents::rank_type;
+    using layout_type = layout_padded;
+
+    static constexpr std::size_t rank = Extents::rank();
+    static_assert(rank > 0, "layout_padded needs at least one extent");
+
+    constexpr mapping() noexcept = default;
+
+    // static RowStride
+    constexpr explicit mapping(extents_type const& ext) noexcept
+        requires(RowStride != std::dynamic_extent)
+        : ext_(ext) {}
+
+    // run-time row stride
+    constexpr mapping(extents_type const& ext, index_type row_stride) noexcept
+        requires(RowStride == std::dynamic_extent)
+        : ext_(ext), row_stride_(row_stride) {}
+
+    constexpr extents_type const& extents() const noexcept { return ext_; }
+
+    constexpr index_type row_stride() const noexcept {
+      if constexpr (RowStride == std::dynamic_extent)
+        return row_stride_;
+      else
+        return RowStride;
+    }
+
+    constexpr index_type stride(rank_type r) const noexcept {
+      if (r + 1 == rank)
+        return 1;
+      index_type s = row_stride();
+      for (rank_type q = rank - 2; q > r; --q)
+        s *= ext_.extent(q);
+      return s;
+    }
+
+    template <typename... Indices>
+    constexpr index_type operator()(Indices... indices) const noexcept {
+      index_type i[] = {static_cast<index_type>(indices)...};
+      index_type offset = i[rank - 1];
+      index_type s = row_stride();
+      for (rank_type r = rank - 1; r-- > 0;) {
+        offset += i[r] * s;
+        s *= ext_.extent(r);
+      }
+      return offset;
+    }
+
+    constexpr index_type required_span_size() const noexcept {
+      index_type size = 1;
+      for (rank_type r = 0; r < rank; ++r) {
+        if (ext_.extent(r) == 0)
+          return 0;
+        size += (ext_.extent(r) - 1) * stride(r);
+      }
+      return size;
+    }
+
+    static constexpr bool is_always_unique() noexcept { return true; }
+    static constexpr bool is_always_exhaustive() noexcept { return false; }
+    static constexpr bool is_always_strided() noexcept { return true; }
+
+    static constexpr bool is_unique() noexcept { return true; }
+    constexpr bool is_exhaustive() const noexcept {
+      return rank == 1 || row_stride() == ext_.extent(rank - 1);
+    }
+    static constexpr bool is_strided() noexcept { return true; }
+
+    friend constexpr bool operator==(mapping const& a,
+                                     mapping const& b) noexcept {
+      return a.extents() == b.extents() && a.row_stride() == b.row_stride();
+    }
+
+   private:
+    extents_type ext_{};
+    index_type row_stride_ = 0;
+  };
+};
+
+// row-major mapping whose rows are padded by pad cache lines (see
+// padded_stride), with the row stride given at run time
+template <typename T, typename Extents>
+typename layout_padded<>::template mapping<Extents> padded_mapping(
+    Extents const& ext, int pad = 0) {
+  constexpr std::size_t rank = Extents::rank();
+  return {ext, static_cast<typename Extents::index_type>(
+                   padded_stride<T>(ext.extent(rank - 1), pad))};
+}
+
+// padding of a grid known at compile time: the unpadded (0) or automatic (-1)
+// layout. make_aligned_view takes it in place of an int pad
+template <int Pad>
+using static_pad = std::integral_constant<int, Pad>;
+
+// aligned row-major view
+template <typename T, typename Extents, typename Layout = layout_padded<>>
+using aligned_view = std::mdspan<T, Extents, Layout, aligned_accessor<T>>;
+
+// aligned view of a grid padded by pad cache lines, with the most static
+// mapping pad allows: layout_right for static_pad<0>, a compile-time row
+// stride for another static_pad with static extents, and a run-time row
+// stride otherwise
+template <typename T, typename Extents, typename Pad = int>
+auto make_aligned_view(T* data, Extents const& ext, Pad pad = 0) {
+  constexpr std::size_t rank = Extents::rank();
+
+  if constexpr (std::is_same_v<Pad, static_pad<0>>) {
+    return aligned_view<T, Extents, std::layout_right>(data, ext);
+  } else if constexpr (!std::is_same_v<Pad, int> &&
+                       Extents::rank_dynamic() == 0) {
+    using layout = layout_padded<padded_stride<T>(
+        Extents::static_extent(rank - 1), Pad::value)>;
+    return aligned_view<T, Extents, layout>(
+        data, typename layout::template mapping<Extents>(ext));
+  } else {
+    return aligned_view<T, Extents>(data, padded_mapping<T>(ext, pad));
+  }
+}
+
+// allocate n elements of T aligned to a cache line
+template <typename T>
+T* aligned_new(std::size_t n) {
+  return static_cast<T*>(
+      ::operator new[](n * sizeof(T), std::align_val_t{cache_line}));
+}
+
+template <typename T>
+void aligned_delete(T* p) {
+  ::operator delete[](p, std::align_val_t{cache_line});
+}
+
+// the two time levels of a stepper: cache-line aligned buffers that are
+// allocated on first use, grown on demand and reused by later runs, so that
+// warm runs pay no allocation or first-touch page faults
+template <typename T>
+class buffer_pair {
+ public:
+  buffer_pair() = default;
+  buffer_pair(buffer_pair const&) = delete;
+  buffer_pair& operator=(buffer_pair const&) = delete;
+
+  ~buffer_pair() { release(); }
+
+  // both buffers hold at least n elements. the contents are not preserved
+  void reserve(std::size_t n) {
+    if (n <= capacity_)
+      return;
+    release();
+    for (auto& p : ptr_)
+      p = aligned_new<T>(n);
+    capacity_ = n;
+  }
+
+  T* operator[](std::size_t i) const { return ptr_[i]; }
+
+ private:
+  void release() {
+    for (auto& p : ptr_) {
+      if (p)
+        aligned_delete(p);
+      p = nullptr;
+    }
+    capacity_ = 0;
+  }
+
+  std::array<T*, 2> ptr_ = {nullptr, nullptr};
+  std::size_t capacity_ = 0;
+};
@@ -0,0 +1,74 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// dynamic chunking of an index space across the workers of a bulk sender
+//
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "commons.hpp"
+
+// worker threads to use: n, or one per hardware thread if n is 0
+inline std::size_t worker_count(std::size_t n) {
+  if (n == 0)
+    n = std::thread::hardware_concurrency();
+  return std::max<std::size_t>(n, 1);
+}
+
+// indices claimed per fetch when n indices are shared by nworkers: about 8
+// chunks per worker, so that uneven or very fine work still balances
+inline std::size_t chunk_grain(std::size_t n, std::size_t nworkers) {
+  return std::max<std::size_t>(n / (8 * nworkers), 1);
+}
+
+// shared cursor over [0, n). every worker of a bulk(nworkers, ...) calls run()
+// and claims grain indices at a time until the range is exhausted, so the
+// number of tasks is independent of the number of threads. reset() before
+// each bulk
+class chunk_counter {
+ public:
+  void reset() { next_.store(0, std::memory_order_relaxed); }
+
+  template <typename F>
+  void run(std::size_t n, std::size_t grain, F&& f) {
+    for (std::size_t b = claim(grain); b < n; b = claim(grain)) {
+      std::size_t e = std::min(b + grain, n);
+      for (std::size_t i = b; i < e; ++i)
+        f(i);
+    }
+  }
+
+ private:
+  std::size_t claim(std::size_t grain) {
+    return next_.fetch_add(grain, std::memory_order_relaxed);
+  }
+
+  std::atomic<std::size_t> next_{0};
+};
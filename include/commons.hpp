@@ -31,6 +31,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
@@ -41,8 +42,10 @@
 #include <memory>
 #include <numeric>
 #include <span>
+#include <string>
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
 #include <vector>
 
 #include "counting_iterator.hpp"
@@ -52,9 +55,9 @@
   int ii = x / ms.extent(1); \
   int ij = x % ms.extent(1);
 // get mdspan 3d indices from 1d index
-#define dim3(x, ms)                            \
-  int ii = x / (ms3.extent(1) * ms.extent(2)); \
-  int ij = (x / ms.extent(2)) % ms.extent(1);  \
+#define dim3(x, ms)                           \
+  int ii = x / (ms.extent(1) * ms.extent(2)); \
+  int ij = (x / ms.extent(2)) % ms.extent(1); \
   int ik = x % ms.extent(2)
 
 class Timer {
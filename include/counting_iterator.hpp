@@ -33,17 +33,16 @@
 
 #include "commons.hpp"
 
-using Index_t = int32_t;
-
+template <typename Index = std::int32_t>
 struct counting_iterator {
  private:
   using self = counting_iterator;
 
  public:
-  using value_type = Index_t;
-  using difference_type = typename std::make_signed<Index_t>::type;
-  using pointer = Index_t*;
-  using reference = Index_t&;
+  using value_type = Index;
+  using difference_type = typename std::make_signed<Index>::type;
+  using pointer = Index*;
+  using reference = Index&;
   using iterator_category = std::random_access_iterator_tag;
 
   counting_iterator() : value(0) {}
@@ -128,4 +127,15 @@ struct counting_iterator {
 
  private:
   value_type value;
-};
\ No newline at end of file
+};
+
+// std::for_each_n over the indices [0, n). The 32-bit counting_iterator is used
+// whenever the range fits (cheaper induction variables and vectorization) and
+// a 64-bit one otherwise
+template <typename ExecutionPolicy, typename F>
+void for_each_index(ExecutionPolicy&& policy, std::uint64_t n, F&& f) {
+  if (n <= static_cast<std::uint64_t>(INT32_MAX))
+    std::for_each_n(policy, counting_iterator<std::int32_t>(0), n, f);
+  else
+    std::for_each_n(policy, counting_iterator<std::int64_t>(0), n, f);
+}
@@ -0,0 +1,195 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// ranges-compatible counting range and an adapter that lets lazy views (e.g.
+// views::transform pipelines) be passed to the parallel algorithms
+//
+
+#pragma once
+
+#include <ranges>
+
+#include "counting_iterator.hpp"
+
+// sized random access range over the indices [first, last)
+template <typename Index = std::int32_t>
+class counting_range
+    : public std::ranges::view_interface<counting_range<Index>> {
+ public:
+  using iterator = counting_iterator<Index>;
+
+  counting_range() = default;
+
+  explicit counting_range(Index n) : first(0), last(n) {}
+
+  counting_range(Index first, Index last) : first(first), last(last) {}
+
+  iterator begin() const { return iterator(first); }
+
+  iterator end() const { return iterator(last); }
+
+  std::size_t size() const { return last - first; }
+
+ private:
+  Index first = 0;
+  Index last = 0;
+};
+
+template <typename Index>
+counting_range(Index) -> counting_range<Index>;
+
+template <typename Index>
+counting_range(Index, Index) -> counting_range<Index>;
+
+// iterators do not refer back to the range
+template <typename Index>
+inline constexpr bool
+    std::ranges::enable_borrowed_range<counting_range<Index>> = true;
+
+static_assert(std::random_access_iterator<counting_iterator<>>);
+static_assert(std::ranges::random_access_range<counting_range<>>);
+static_assert(std::ranges::sized_range<counting_range<>>);
+
+// the parallel algorithms dispatch on the C++17 iterator_category, which is
+// only input_iterator_tag for the iterators of views returning prvalues (e.g.
+// views::transform). parallel_iterator forwards to such an iterator and
+// advertises random access
+template <std::random_access_iterator It>
+class parallel_iterator {
+ private:
+  using self = parallel_iterator;
+
+ public:
+  using value_type = std::iter_value_t<It>;
+  using difference_type = std::iter_difference_t<It>;
+  using pointer = void;
+  using reference = std::iter_reference_t<It>;
+  using iterator_category = std::random_access_iterator_tag;
+
+  parallel_iterator() = default;
+
+  explicit parallel_iterator(It it) : it(it) {}
+
+  reference operator*() const { return *it; }
+
+  reference operator[](difference_type n) const { return it[n]; }
+
+  self& operator++() {
+    ++it;
+    return *this;
+  }
+
+  self operator++(int) {
+    self result{it};
+    ++it;
+    return result;
+  }
+
+  self& operator--() {
+    --it;
+    return *this;
+  }
+
+  self operator--(int) {
+    self result{it};
+    --it;
+    return result;
+  }
+
+  self& operator+=(difference_type n) {
+    it += n;
+    return *this;
+  }
+
+  self& operator-=(difference_type n) {
+    it -= n;
+    return *this;
+  }
+
+  friend self operator+(self const& i, difference_type n) {
+    return self(i.it + n);
+  }
+
+  friend self operator+(difference_type n, self const& i) {
+    return self(i.it + n);
+  }
+
+  friend difference_type operator-(self const& x, self const& y) {
+    return x.it - y.it;
+  }
+
+  friend self operator-(self const& i, difference_type n) {
+    return self(i.it - n);
+  }
+
+  friend bool operator==(self const& x, self const& y) { return x.it == y.it; }
+
+  friend bool operator!=(self const& x, self const& y) { return x.it != y.it; }
+
+  friend bool operator<(self const& x, self const& y) { return x.it < y.it; }
+
+  friend bool operator<=(self const& x, self const& y) { return x.it <= y.it; }
+
+  friend bool operator>(self const& x, self const& y) { return x.it > y.it; }
+
+  friend bool operator>=(self const& x, self const& y) { return x.it >= y.it; }
+
+ private:
+  It it;
+};
+
+// owns a random access, sized, common view and exposes parallel_iterators
+// over it. the view is stored here because e.g. views::transform iterators
+// point back to their view, so it must outlive the algorithm
+template <std::ranges::view V>
+  requires std::ranges::random_access_range<V> &&
+           std::ranges::sized_range<V> && std::ranges::common_range<V>
+class parallel_view : public std::ranges::view_interface<parallel_view<V>> {
+ public:
+  using iterator = parallel_iterator<std::ranges::iterator_t<V>>;
+
+  parallel_view() = default;
+
+  explicit parallel_view(V base) : base(std::move(base)) {}
+
+  iterator begin() { return iterator(std::ranges::begin(base)); }
+
+  iterator end() { return iterator(std::ranges::end(base)); }
+
+  auto size() { return std::ranges::size(base); }
+
+ private:
+  V base;
+};
+
+// e.g. std::reduce(policy, v.begin(), v.end()) with
+// auto v = as_parallel(counting_range(n) | std::views::transform(f));
+template <std::ranges::viewable_range R>
+auto as_parallel(R&& r) {
+  return parallel_view<std::views::all_t<R>>(
+      std::views::all(std::forward<R>(r)));
+}
@@ -0,0 +1,203 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// self-contained parallel FFT: iterative radix-2 for power-of-two lengths and
+// Bluestein's chirp-z transform (on top of radix-2) for any other length
+//
+
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <complex>
+#include <numbers>
+
+#include "commons.hpp"
+
+using complex_t = std::complex<double>;
+
+// reverse the low log2n bits of i
+inline std::size_t bit_reverse(std::size_t i, int log2n) {
+  std::size_t r = 0;
+  for (int b = 0; b < log2n; ++b, i >>= 1)
+    r = (r << 1) | (i & 1);
+  return r;
+}
+
+// in-place unnormalized DFT of a[0, n), n a power of two.
+// sign = -1: forward, sign = +1: inverse
+template <typename ExecutionPolicy>
+void fft_pow2(ExecutionPolicy&& policy, complex_t* a, std::size_t n,
+              int sign) {
+  if (n < 2)
+    return;
+
+  int log2n = std::countr_zero(n);
+
+  // twiddles w[k] = exp(sign * 2 pi i k / n), k < n / 2
+  std::vector<complex_t> w(n / 2);
+  complex_t* wp = w.data();
+  for_each_index(policy, n / 2, [=](std::size_t k) {
+    double phi = sign * 2 * std::numbers::pi * double(k) / double(n);
+    wp[k] = complex_t(std::cos(phi), std::sin(phi));
+  });
+
+  for_each_index(policy, n, [=](std::size_t i) {
+    std::size_t r = bit_reverse(i, log2n);
+    if (i < r)
+      std::swap(a[i], a[r]);
+  });
+
+  // one parallel pass of n / 2 butterflies per stage
+  for (std::size_t len = 2; len <= n; len *= 2) {
+    std::size_t half = len / 2;
+    std::size_t stride = n / len;
+    for_each_index(policy, n / 2, [=](std::size_t b) {
+      std::size_t i = (b / half) * len + b % half;
+      complex_t t = wp[(b % half) * stride] * a[i + half];
+      a[i + half] = a[i] - t;
+      a[i] += t;
+    });
+  }
+}
+
+// in-place unnormalized DFT of a[0, n) for any n, as a convolution with the
+// chirp exp(-sign * pi i k^2 / n) of power-of-two length m >= 2n - 1
+template <typename ExecutionPolicy>
+void fft_bluestein(ExecutionPolicy&& policy, complex_t* a, std::size_t n,
+                   int sign) {
+  std::size_t m = std::bit_ceil(2 * n - 1);
+
+  // chirp[k] = exp(sign * pi i k^2 / n). k^2 is reduced mod 2n to keep the
+  // phase accurate for large k
+  std::vector<complex_t> chirp(n);
+  std::vector<complex_t> A(m), B(m);
+  complex_t* cp = chirp.data();
+  complex_t* Ap = A.data();
+  complex_t* Bp = B.data();
+
+  for_each_index(policy, n, [=](std::size_t k) {
+    std::size_t k2 = (std::uint64_t(k) * k) % (2 * n);
+    double phi = sign * std::numbers::pi * double(k2) / double(n);
+    cp[k] = complex_t(std::cos(phi), std::sin(phi));
+  });
+
+  for_each_index(policy, m, [=](std::size_t k) {
+    Ap[k] = k < n ? a[k] * cp[k] : complex_t(0);
+    if (k < n)
+      Bp[k] = std::conj(cp[k]);
+    else if (k > m - n)
+      Bp[k] = std::conj(cp[m - k]);
+    else
+      Bp[k] = complex_t(0);
+  });
+
+  fft_pow2(policy, Ap, m, -1);
+  fft_pow2(policy, Bp, m, -1);
+  for_each_index(policy, m, [=](std::size_t k) { Ap[k] *= Bp[k]; });
+  fft_pow2(policy, Ap, m, +1);
+
+  for_each_index(policy, n, [=](std::size_t k) {
+    a[k] = cp[k] * Ap[k] / double(m);
+  });
+}
+
+// in-place unnormalized DFT of a. sign = -1: forward, sign = +1: inverse
+template <typename ExecutionPolicy>
+void fft(ExecutionPolicy&& policy, std::vector<complex_t>& a, int sign) {
+  std::size_t n = a.size();
+  if (std::has_single_bit(n) || n < 2)
+    fft_pow2(policy, a.data(), n, sign);
+  else
+    fft_bluestein(policy, a.data(), n, sign);
+}
+
+// u after nt steps of the explicit periodic heat update
+// u[i] += c * (u[i - 1] - 2 * u[i] + u[i + 1]), c = k * dt / dx^2.
+// the update multiplies Fourier mode m by 1 - 4 c sin^2(pi m / n), so all nt
+// steps are one forward FFT, a scaling and one inverse FFT. the result equals
+// the explicit kernels' up to rounding
+template <typename ExecutionPolicy>
+void heat_spectral(ExecutionPolicy&& policy, double* u, std::size_t n,
+                   std::size_t nt, double c) {
+  std::vector<complex_t> f(n);
+  complex_t* fp = f.data();
+
+  for_each_index(policy, n, [=](std::size_t i) { fp[i] = u[i]; });
+
+  fft(policy, f, -1);
+
+  for_each_index(policy, n, [=](std::size_t m) {
+    double s = std::sin(std::numbers::pi * double(m) / double(n));
+    fp[m] *= std::pow(1 - 4 * c * s * s, double(nt)) / double(n);
+  });
+
+  fft(policy, f, +1);
+
+  for_each_index(policy, n, [=](std::size_t i) { u[i] = fp[i].real(); });
+}
+
+// z^e by squaring
+inline complex_t pow_int(complex_t z, std::size_t e) {
+  complex_t r = 1;
+  for (; e; e >>= 1, z *= z)
+    if (e & 1)
+      r *= z;
+  return r;
+}
+
+// u after nt steps of the periodic stencil next[i] = sum_j w[j] u[i + j - R],
+// j in [0, 2 R]. Fourier mode m is multiplied by
+// sum_j w[j] exp(2 pi i m (j - R) / n) per step
+template <typename ExecutionPolicy>
+void stencil_spectral(ExecutionPolicy&& policy, double* u, std::size_t n,
+                      std::size_t nt, const double* w, int R) {
+  std::vector<complex_t> f(n);
+  std::vector<double> weights(w, w + 2 * R + 1);
+  complex_t* fp = f.data();
+  const double* wp = weights.data();
+
+  for_each_index(policy, n, [=](std::size_t i) { fp[i] = u[i]; });
+
+  fft(policy, f, -1);
+
+  for_each_index(policy, n, [=](std::size_t m) {
+    complex_t lambda = 0;
+    for (int j = 0; j <= 2 * R; ++j) {
+      // (j - R) m reduced mod n keeps the phase accurate for large m
+      std::int64_t d = ((std::int64_t(j - R) % std::int64_t(n)) + n) % n;
+      std::size_t k = (std::uint64_t(d) * m) % n;
+      double phi = 2 * std::numbers::pi * double(k) / double(n);
+      lambda += wp[j] * complex_t(std::cos(phi), std::sin(phi));
+    }
+    fp[m] *= pow_int(lambda, nt) / double(n);
+  });
+
+  fft(policy, f, +1);
+
+  for_each_index(policy, n, [=](std::size_t i) { u[i] = fp[i].real(); });
+}
@@ -0,0 +1,71 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// fork-join of two closures on an exec::async_scope, for recursive
+// algorithms whose parallelism is only known while they run
+//
+
+#pragma once
+
+#include <atomic>
+#include <exec/async_scope.hpp>
+#include <memory>
+#include <stdexec/execution.hpp>
+
+// run f and g in parallel and return when both are done. g is spawned onto
+// the scheduler while f runs on the calling thread; if no worker has started
+// g by the time f returns, the caller takes it back and runs it inline. a join
+// therefore only ever waits for a task that is already running, so nested
+// forks cannot deadlock the pool. tasks that were taken back still leave an
+// empty spawn behind: sync_wait(scope.on_empty()) before the scope goes away
+template <typename F, typename G>
+void fork_join(exec::async_scope& scope, stdexec::scheduler auto sch, F&& f,
+               G&& g) {
+  struct fork_state {
+    std::atomic<bool> claimed{false};
+    std::atomic<bool> done{false};
+  };
+
+  // the spawned task only touches g after claiming it, and the caller waits
+  // for it in that case, so g may live on the caller's stack
+  auto state = std::make_shared<fork_state>();
+  auto* task = &g;
+  scope.spawn(stdexec::schedule(sch) | stdexec::then([state, task] {
+                if (state->claimed.exchange(true, std::memory_order_acq_rel))
+                  return;
+                (*task)();
+                state->done.store(true, std::memory_order_release);
+                state->done.notify_one();
+              }));
+
+  f();
+
+  if (!state->claimed.exchange(true, std::memory_order_acq_rel))
+    g();
+  else
+    state->done.wait(false, std::memory_order_acquire);
+}
@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// reference solutions of the 1d_stencil apps for --validate: the periodic
+// grid starts at u[i] = i and the state after nt steps comes from a single
+// spectral solve (see fft.hpp), independent of the kernel being checked
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "commons.hpp"
+#include "fft.hpp"
+
+// u[0, size) after nt steps of the three-point heat update with
+// c = k * dt / dx^2
+template <typename ExecutionPolicy>
+void heat_reference(ExecutionPolicy&& policy, double* u, std::size_t size,
+                    std::size_t nt, double c) {
+  for_each_index(policy, size, [=](std::size_t i) { u[i] = (double)i; });
+  heat_spectral(policy, u, size, nt, c);
+}
+
+// u[0, size) after nt steps of the stencil with weights w[0, 2 R]
+template <typename ExecutionPolicy>
+void stencil_reference(ExecutionPolicy&& policy, double* u, std::size_t size,
+                       std::size_t nt, const double* w, int R) {
+  for_each_index(policy, size, [=](std::size_t i) { u[i] = (double)i; });
+  stencil_spectral(policy, u, size, nt, w, R);
+}
+
+// max |u(i) - exact[i] - shift| over the grid. u(i) returns grid point i of
+// the solution, whatever its storage
+template <typename U>
+double max_error(U&& u, std::vector<double> const& exact, double shift = 0) {
+  double error = 0;
+  for (std::size_t i = 0; i != exact.size(); ++i)
+    error = std::max(error, std::abs(u(i) - exact[i] - shift));
+  return error;
+}
+
+inline void print_error(double error) {
+  std::cout << "Max error: " << error << "\n";
+}
+
+// print the max error of the heat solution u(i) against the reference
+template <typename ExecutionPolicy, typename U>
+void validate_heat(ExecutionPolicy&& policy, U&& u, std::size_t size,
+                   std::size_t nt, double c) {
+  std::vector<double> exact(size);
+  heat_reference(policy, exact.data(), size, nt, c);
+  print_error(max_error(u, exact));
+}
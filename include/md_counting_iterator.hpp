@@ -0,0 +1,226 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// N-dimensional counting iterator: yields the (i, j[, k, ...]) indices of a
+// row-major index space, e.g. the extents of an mdspan, in linear order
+//
+
+#pragma once
+
+#include "commons.hpp"
+
+// divisor with a precomputed reciprocal so that n / d and n % d need no
+// hardware divide for 32-bit indices (Lemire et al., "Faster Remainder by
+// Direct Computation", 2019). Wider indices fall back to plain division
+template <typename Index>
+struct fast_divisor {
+  using UIndex = std::make_unsigned_t<Index>;
+
+  fast_divisor() = default;
+
+  explicit fast_divisor(Index d)
+      : d(d), m(d > 1 ? UINT64_MAX / static_cast<std::uint64_t>(d) + 1 : 0) {}
+
+  Index div(Index n) const {
+    if constexpr (sizeof(Index) <= 4) {
+      if (d == 1)
+        return n;
+      return static_cast<Index>(
+          (static_cast<__uint128_t>(m) * static_cast<UIndex>(n)) >> 64);
+    } else {
+      return n / d;
+    }
+  }
+
+  Index mod(Index n) const {
+    if constexpr (sizeof(Index) <= 4) {
+      std::uint64_t low = m * static_cast<UIndex>(n);
+      return static_cast<Index>((static_cast<__uint128_t>(low) * d) >> 64);
+    } else {
+      return n % d;
+    }
+  }
+
+  Index d = 1;
+  std::uint64_t m = 0;
+};
+
+template <typename Index, std::size_t Rank>
+struct md_counting_iterator {
+ private:
+  using self = md_counting_iterator;
+
+ public:
+  using value_type = std::array<Index, Rank>;
+  using difference_type = typename std::make_signed<Index>::type;
+  using pointer = void;
+  using reference = value_type;
+  using iterator_category = std::random_access_iterator_tag;
+
+  md_counting_iterator() = default;
+
+  // iterate over [0, ext[0]) x ... x [0, ext[Rank-1]) starting at the linear
+  // (row-major) position 'start'
+  template <typename Extents>
+  explicit md_counting_iterator(Extents const& ext, Index start = 0)
+      : value(start) {
+    static_assert(Extents::rank() == Rank);
+    for (std::size_t r = 0; r < Rank; ++r)
+      extent[r] = fast_divisor<Index>(ext.extent(r));
+    decompose();
+  }
+
+  value_type operator*() const { return index; }
+
+  value_type operator[](difference_type n) const { return (*this + n).index; }
+
+  // the innermost index is incremented and carried into the outer ones, so
+  // sequential traversal needs no division at all
+  self& operator++() {
+    ++value;
+    for (std::size_t r = Rank; r-- > 0;) {
+      if (++index[r] < extent[r].d || r == 0)
+        break;
+      index[r] = 0;
+    }
+    return *this;
+  }
+
+  self operator++(int) {
+    self result{*this};
+    ++*this;
+    return result;
+  }
+
+  self& operator--() {
+    --value;
+    for (std::size_t r = Rank; r-- > 0;) {
+      if (index[r]-- > 0 || r == 0)
+        break;
+      index[r] = extent[r].d - 1;
+    }
+    return *this;
+  }
+
+  self operator--(int) {
+    self result{*this};
+    --*this;
+    return result;
+  }
+
+  self& operator+=(difference_type n) {
+    value += n;
+    decompose();
+    return *this;
+  }
+
+  self& operator-=(difference_type n) {
+    value -= n;
+    decompose();
+    return *this;
+  }
+
+  friend self operator+(self i, difference_type n) { return i += n; }
+
+  friend self operator+(difference_type n, self i) { return i += n; }
+
+  friend difference_type operator-(self const& x, self const& y) {
+    return x.value - y.value;
+  }
+
+  friend self operator-(self i, difference_type n) { return i -= n; }
+
+  friend bool operator==(self const& x, self const& y) {
+    return x.value == y.value;
+  }
+
+  friend bool operator!=(self const& x, self const& y) {
+    return x.value != y.value;
+  }
+
+  friend bool operator<(self const& x, self const& y) {
+    return x.value < y.value;
+  }
+
+  friend bool operator<=(self const& x, self const& y) {
+    return x.value <= y.value;
+  }
+
+  friend bool operator>(self const& x, self const& y) {
+    return x.value > y.value;
+  }
+
+  friend bool operator>=(self const& x, self const& y) {
+    return x.value >= y.value;
+  }
+
+ private:
+  // linear position -> multi-index via the precomputed reciprocals
+  void decompose() {
+    Index rest = value;
+    for (std::size_t r = Rank; r-- > 1;) {
+      Index q = extent[r].div(rest);
+      index[r] = rest - q * extent[r].d;
+      rest = q;
+    }
+    index[0] = rest;
+  }
+
+  Index value = 0;
+  value_type index{};
+  std::array<fast_divisor<Index>, Rank> extent{};
+};
+
+template <typename Extents>
+md_counting_iterator(Extents const&)
+    -> md_counting_iterator<typename Extents::index_type, Extents::rank()>;
+
+template <typename Extents, typename Index>
+md_counting_iterator(Extents const&, Index)
+    -> md_counting_iterator<typename Extents::index_type, Extents::rank()>;
+
+// [begin, end) over all indices of the given extents
+template <typename Extents>
+struct md_index_range {
+  using iterator =
+      md_counting_iterator<typename Extents::index_type, Extents::rank()>;
+
+  explicit md_index_range(Extents const& ext) : ext(ext) {}
+
+  iterator begin() const { return iterator(ext); }
+
+  iterator end() const { return iterator(ext, size()); }
+
+  typename Extents::index_type size() const {
+    typename Extents::index_type n = 1;
+    for (std::size_t r = 0; r < Extents::rank(); ++r)
+      n *= ext.extent(r);
+    return n;
+  }
+
+  Extents ext;
+};
@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// mdspan layout for the packed lower triangle of a symmetric or triangular
+// n x n matrix: rows of the lower triangle stored one after the other in
+// n (n + 1) / 2 elements
+//
+
+#pragma once
+
+#include <experimental/mdspan>
+
+#include "commons.hpp"
+
+// elements of the packed lower triangle of an n x n matrix
+constexpr std::size_t packed_size(std::size_t n) {
+  return n * (n + 1) / 2;
+}
+
+// (i, j) with j <= i is stored at i (i + 1) / 2 + j, so row i of the lower
+// triangle is contiguous. (i, j) with j > i maps to (j, i): the view reads as
+// the full symmetric matrix, and it is not unique
+struct layout_packed_lower {
+  template <typename Extents>
+  class mapping {
+   public:
+    using extents_type = Extents;
+    using index_type = typename extents_type::index_type;
+    using size_type = typename extents_type::size_type;
+    using rank_type = typename extents_type::rank_type;
+    using layout_type = layout_packed_lower;
+
+    static_assert(extents_type::rank() == 2, "packed layout is 2D");
+
+    constexpr mapping() noexcept = default;
+    constexpr mapping(mapping const&) noexcept = default;
+    constexpr mapping(extents_type const& ext) noexcept : ext_(ext) {}
+
+    constexpr mapping& operator=(mapping const&) noexcept = default;
+
+    constexpr extents_type const& extents() const noexcept { return ext_; }
+
+    constexpr index_type required_span_size() const noexcept {
+      return static_cast<index_type>(packed_size(ext_.extent(0)));
+    }
+
+    template <typename I, typename J>
+    constexpr index_type operator()(I i, J j) const noexcept {
+      index_type r = i < j ? j : i;
+      index_type c = i < j ? i : j;
+      return r * (r + 1) / 2 + c;
+    }
+
+    static constexpr bool is_always_unique() noexcept { return false; }
+    static constexpr bool is_always_exhaustive() noexcept { return true; }
+    static constexpr bool is_always_strided() noexcept { return false; }
+
+    static constexpr bool is_unique() noexcept { return false; }
+    static constexpr bool is_exhaustive() noexcept { return true; }
+    static constexpr bool is_strided() noexcept { return false; }
+
+    template <typename OtherExtents>
+    friend constexpr bool operator==(
+        mapping const& a, mapping<OtherExtents> const& b) noexcept {
+      return a.extents() == b.extents();
+    }
+
+   private:
+    extents_type ext_{};
+  };
+};
+
+// packed lower triangle of an n x n matrix. 64-bit indices: r (r + 1) / 2
+// overflows int past n = 46340
+template <typename T>
+using packed_lower_view = std::mdspan<
+    T, std::extents<std::int64_t, std::dynamic_extent, std::dynamic_extent>,
+    layout_packed_lower>;
@@ -0,0 +1,116 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2023 The Regents of the University of California,
+ * through Lawrence Berkeley National Laboratory (subject to receipt of any
+ * required approvals from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// space-filling curves (Morton/Z-order and Hilbert) for ordering 2D tiles
+//
+
+#pragma once
+
+#include "commons.hpp"
+
+// supported tile traversal orders
+enum class sfc_t { none, morton, hilbert };
+
+// parse a curve name: "none", "morton" or "hilbert"
+inline sfc_t to_sfc(std::string const& name) {
+  if (name == "morton")
+    return sfc_t::morton;
+  if (name == "hilbert")
+    return sfc_t::hilbert;
+  if (name != "none")
+    std::cerr << "WARNING: unknown curve '" << name << "', using row order"
+              << std::endl;
+  return sfc_t::none;
+}
+
+// gather the even bits of v into the low 32 bits
+constexpr std::uint32_t compact_bits(std::uint64_t v) {
+  v &= 0x5555555555555555ull;
+  v = (v | (v >> 1)) & 0x3333333333333333ull;
+  v = (v | (v >> 2)) & 0x0f0f0f0f0f0f0f0full;
+  v = (v | (v >> 4)) & 0x00ff00ff00ff00ffull;
+  v = (v | (v >> 8)) & 0x0000ffff0000ffffull;
+  v = (v | (v >> 16)) & 0x00000000ffffffffull;
+  return static_cast<std::uint32_t>(v);
+}
+
+// Morton index d -> (x, y)
+constexpr std::pair<std::uint32_t, std::uint32_t> morton_d2xy(std::uint64_t d) {
+  return {compact_bits(d), compact_bits(d >> 1)};
+}
+
+// Hilbert index d -> (x, y) on an n x n grid (n must be a power of two)
+constexpr std::pair<std::uint32_t, std::uint32_t> hilbert_d2xy(
+    std::uint32_t n, std::uint64_t d) {
+  std::uint32_t x = 0, y = 0;
+  for (std::uint32_t s = 1; s < n; s *= 2) {
+    std::uint32_t rx = 1 & (d / 2);
+    std::uint32_t ry = 1 & (d ^ rx);
+
+    // rotate the quadrant
+    if (ry == 0) {
+      if (rx == 1) {
+        x = s - 1 - x;
+        y = s - 1 - y;
+      }
+      std::swap(x, y);
+    }
+
+    x += s * rx;
+    y += s * ry;
+    d /= 4;
+  }
+  return {x, y};
+}
+
+// (x, y) coordinates of an nx x ny grid visited in the given curve order. The
+// curve is laid over the enclosing power-of-two square and points outside the
+// grid are skipped
+inline std::vector<std::pair<int, int>> sfc_order(int nx, int ny, sfc_t curve) {
+  std::vector<std::pair<int, int>> order;
+  order.reserve(static_cast<std::size_t>(nx) * ny);
+
+  if (curve == sfc_t::none) {
+    for (int y = 0; y < ny; ++y)
+      for (int x = 0; x < nx; ++x)
+        order.emplace_back(x, y);
+    return order;
+  }
+
+  std::uint32_t n = 1;
+  while (n < static_cast<std::uint32_t>(std::max(nx, ny)))
+    n *= 2;
+
+  for (std::uint64_t d = 0; d < static_cast<std::uint64_t>(n) * n; ++d) {
+    auto [x, y] =
+        (curve == sfc_t::morton) ? morton_d2xy(d) : hilbert_d2xy(n, d);
+    if (x < static_cast<std::uint32_t>(nx) &&
+        y < static_cast<std::uint32_t>(ny))
+      order.emplace_back(x, y);
+  }
+  return order;
+}
@@ -0,0 +1,34 @@
+#!/bin/bash -le
+
+#
+# Sweep the grid size (-n) of a heat-equation app around power-of-two row
+# lengths with and without row padding and write the per-size timings as CSV.
+# Cache-set aliasing shows up as spikes in the pad=0 (unpadded) curve at
+# n = 2^k - 2 (rows of 2^k doubles including ghosts) that disappear with
+# pad=-1 (auto).
+#
+# Usage (from the heat-equation build directory):
+#
+# ../../../scripts/heat-pad-sweep.sh [app] [steps] [window] > sweep.csv
+#
+
+APP=${1:-./heat-equation-stdpar}
+STEPS=${2:-20}
+WINDOW=${3:-6}
+
+# row lengths (including ghosts) to sweep around
+ROWS=(1024 2048 4096 8192 16384)
+
+# padding modes: none (layout_right) and automatic
+PADS=(0 -1)
+
+echo "n,pad,time_ms"
+
+for r in "${ROWS[@]}"; do
+    for ((n = r - 2 - WINDOW; n <= r - 2 + WINDOW; n++)); do
+        for p in "${PADS[@]}"; do
+            t=$(${APP} -n=${n} -s=${STEPS} --pad=${p} --time | awk '/Time:/ {print $2}')
+            echo "${n},${p},${t}"
+        done
+    done
+done
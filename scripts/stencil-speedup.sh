@@ -0,0 +1,31 @@
+#!/bin/bash -le
+
+#
+# Time the 1D stencil variants against stencil_serial on the same grid and
+# write the per-variant timings and speedups as CSV.
+#
+# Usage (from the 1d_stencil build directory):
+#
+# ../../../scripts/stencil-speedup.sh [np] [nx] [nt] > speedup.csv
+#
+
+NP=${1:-100}
+NX=${2:-1000000}
+NT=${3:-100}
+
+APPS=(stencil_stdpar stencil_stdpar_snd stencil_stdpar_snd_iter)
+
+run() {
+    ./$1 --np=${NP} --nx=${NX} --nt=${NT} --time | awk '/Duration:/ {print $2}'
+}
+
+echo "app,np,nx,nt,time_ms,speedup"
+
+base=$(run stencil_serial)
+echo "stencil_serial,${NP},${NX},${NT},${base},1"
+
+for app in "${APPS[@]}"; do
+    t=$(run ${app})
+    s=$(awk -v b=${base} -v t=${t} 'BEGIN {printf "%.2f", b / t}')
+    echo "${app},${NP},${NX},${NT},${t},${s}"
+done